@@ -28,10 +28,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace vsgXchange
 {
+    /// Composite ReaderWriter that holds all the ReaderWriters provided by vsgXchange.
+    /// Stream and memory reads without an Options::extensionHint identify the format from its signature, an image signature also overrides a contradicting hint.
     class VSGXCHANGE_DECLSPEC all : public vsg::Inherit<vsg::CompositeReaderWriter, all>
     {
     public:
         all();
+
+        vsg::ref_ptr<vsg::Object> read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
     };
 } // namespace vsgXchange
 
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 </editor-fold> */
 
 #include <vsg/io/ReaderWriter.h>
+#include <vsg/text/Font.h>
 #include <vsgXchange/Export.h>
 
 #include <memory>
@@ -31,6 +32,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace vsgXchange
 {
 
+    /// freetype ReaderWriter, generates a signed distance field glyph atlas for fonts supported by FreeType.
+    /// When options->fileCache is set the generated vsg::Font is cached as a .vsgb under fileCache/freetype.
+    /// Cached entries are keyed on the font file contents and the options below, so a changed font file is regenerated.
     class VSGXCHANGE_DECLSPEC freetype : public vsg::Inherit<vsg::ReaderWriter, freetype>
     {
     public:
@@ -39,13 +43,83 @@ namespace vsgXchange
 
         bool getFeatures(Features& features) const override;
 
+        // vsg::Options::setValue(str, value) suppoorted options:
+        static constexpr const char* max_threads = "max_threads"; /// uint32_t, number of threads used to compute the glyph atlas, 0 selects std::thread::hardware_concurrency()
+        static constexpr const char* char_ranges = "char_ranges"; /// std::string, comma separated codepoints/ranges up to 0x10FFFF to include in the atlas i.e. "32-126,0x400-0x4FF", default is all glyphs in the font
+        static constexpr const char* dynamic_atlas = "dynamic_atlas"; /// bool, return a DynamicFont that can add glyphs to its atlas on demand, initially containing char_ranges or "32-126"
+        static constexpr const char* sdf_method = "sdf_method"; /// std::string, "outline" computes distances to the glyph outlines (default), "bitmap" uses a distance transform of the rasterized glyph, "msdf"/"msdf16" compute a multi-channel distance field in a R8G8B8A8_SNORM/R16G16B16A16_SNORM atlas
+        static constexpr const char* pixel_size = "pixel_size"; /// uint32_t, size in texels of the glyphs in the atlas, default is 48
+        static constexpr const char* packing = "packing"; /// std::string, method used to place glyphs in the atlas, "shelf" (default) is fastest, "skyline" and "maxrects" pack more tightly at the cost of longer placement times
+        static constexpr const char* supersample = "supersample"; /// uint32_t, supersampling factor used when rasterizing glyphs for the "bitmap" sdf_method, default is 2
+        static constexpr const char* collect_stats = "collect_stats"; /// bool, attach FontStats to the returned Font, accessed via font->getObject<vsgXchange::FontStats>("stats")
+
+        bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
+
     protected:
         ~freetype();
 
         class Implementation;
         Implementation* _implementation;
+
+        friend class DynamicFont;
+    };
+
+    /// counts and timings collected while generating a font's glyph atlas, times are in seconds.
+    class VSGXCHANGE_DECLSPEC FontStats : public vsg::Inherit<vsg::Object, FontStats>
+    {
+    public:
+        uint32_t numGlyphs = 0;
+        uint64_t numTexels = 0;
+        double packingTime = 0.0;  // collecting the glyph sizes and laying out the atlas
+        double outlineTime = 0.0;  // loading the glyphs and decomposing their outlines
+        double distanceTime = 0.0; // computing the signed distance fields, summed across threads
+        double totalTime = 0.0;
+        double packingEfficiency = 0.0; // area of the glyphs divided by the area of the atlas
+    };
+
+    /// Font that retains the FreeType face so glyphs can be added to the atlas after the font has been read.
+    /// Created by the freetype ReaderWriter when the freetype::dynamic_atlas option is set.
+    class VSGXCHANGE_DECLSPEC DynamicFont : public vsg::Inherit<vsg::Font, DynamicFont>
+    {
+    public:
+        DynamicFont();
+
+        struct Region
+        {
+            uint32_t x = 0;
+            uint32_t y = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        /// add glyphs for the charcodes not already in the atlas, returns the number of glyphs added.
+        /// The atlas, glyphMetrics and charmap may be replaced so addGlyphs must not be called while they are in use by other threads.
+        uint32_t addGlyphs(const std::vector<uint32_t>& charcodes);
+
+        /// add glyphs for the characters in text, where wchar_t is 16 bit the text is treated as UTF-16 so surrogate pairs select a single charcode.
+        uint32_t addGlyphs(const std::wstring& text);
+
+        /// return true if the glyph for the charcode is already in the atlas.
+        bool hasGlyph(uint32_t charcode) const;
+
+        /// return the regions of the atlas modified since the last call, so only these need to be transferred to the GPU.
+        /// reallocated is set to true if the atlas has been replaced by a larger one since the last call so must be transferred in full.
+        std::vector<Region> takeDirtyRegions(bool& reallocated);
+
+        /// write as a vsg::Font as DynamicFont isn't registered with the vsg::ObjectFactory.
+        const char* className() const noexcept override { return vsg::type_name<vsg::Font>(); }
+
+    protected:
+        ~DynamicFont();
+
+        class Implementation;
+        Implementation* _implementation;
+
+        friend class freetype;
     };
 
 } // namespace vsgXchange
 
 EVSG_type_name(vsgXchange::freetype);
+EVSG_type_name(vsgXchange::DynamicFont);
+EVSG_type_name(vsgXchange::FontStats);
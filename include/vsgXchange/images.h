@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 </editor-fold> */
 
+#include <vsg/core/Data.h>
 #include <vsg/io/ReaderWriter.h>
 #include <vsgXchange/Version.h>
 
@@ -33,13 +34,52 @@ namespace vsgXchange
 {
     /// Composite ReaderWriter that holds the uses load 3rd party images formats.
     /// By defalt utilizes the stbi, dds and ktx ReaderWriters so that users only need to create vsgXchange::images::create() to utilize them all.
+    /// Stream and memory reads without an Options::extensionHint identify the format from its signature, an image signature also overrides a contradicting hint.
     class VSGXCHANGE_DECLSPEC images : public vsg::Inherit<vsg::CompositeReaderWriter, images>
     {
     public:
         images();
+
+        vsg::ref_ptr<vsg::Object> read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+        vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
+
+        // vsg::Options::setValue(str, value) supported options, honoured by the stbi, dds, ktx and GDAL ReaderWriters:
+        static constexpr const char* probe = "probe"; /// bool, return an ImageInfo describing the image read from its header rather than decoding the pixel data
+
+        // vsg::Options::setValue(str, value) supported options, honoured by the dds and ktx ReaderWriters:
+        static constexpr const char* skip_mip_levels = "skip_mip_levels"; /// uint32_t, number of the largest mipmap levels to leave out when reading textures with mipmaps, the smallest level is always kept
+
+        // vsg::Options::setValue(str, value) supported options, honoured by the stbi, GDAL and OSG ReaderWriters:
+        static constexpr const char* generate_mipmaps = "generate_mipmaps"; /// bool, generate a complete mipmap chain on the CPU for 2D images read without mipmaps, so the GPU doesn't have to and .vsgb files written carry them
+        static constexpr const char* mipmap_filter = "mipmap_filter"; /// std::string, filter used by generate_mipmaps, "box" (default) or "kaiser"
+        static constexpr const char* mipmap_srgb = "mipmap_srgb"; /// bool, treat 8 bit UNORM colour components as sRGB encoded and filter them in linear space, _SRGB formats are always filtered in linear space
+        static constexpr const char* mipmap_threads = "mipmap_threads"; /// uint32_t, maximum number of threads used by generate_mipmaps, 0 selects std::thread::hardware_concurrency()
+    };
+
+    /// dimensions and format of an image, returned by the image ReaderWriters in place of the image data when the images::probe option is set.
+    /// Use a separate vsg::Options for probing so the ImageInfo isn't shared with full reads via options->objectCache.
+    class VSGXCHANGE_DECLSPEC ImageInfo : public vsg::Inherit<vsg::Object, ImageInfo>
+    {
+    public:
+        /// layout the vsg::Data would be assigned when the image is read, including format, block size, mipmap count and image view type.
+        vsg::Data::Layout layout;
+
+        /// dimensions in texels of the base mipmap level.
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t depth = 1;
+
+        /// number of array layers, including the 6 faces of each cube map.
+        uint32_t layers = 1;
+
+        /// number of mipmap levels stored in the file.
+        uint32_t mipLevels = 1;
     };
 
-    /// add png, jpeg and gif support using local build of stbi.
+    /// add png, jpeg, gif and hdr support using local build of stbi.
+    /// Images keep their native channel count and 8 bit, 16 bit or float precision, with RGB expanded to RGBA when Options::mapRGBtoRGBAHint is set.
+    /// When built with vsgXchange_jpegturbo or vsgXchange_spng, JPEG and 8 bit PNG are decoded with libjpeg-turbo or libspng, falling back to stb_image.
+    /// The max_dimension option decodes reduced resolution images for LOD and thumbnail use, JPEG is scaled during decoding by libjpeg-turbo and other images are box filtered.
     class VSGXCHANGE_DECLSPEC stbi : public vsg::Inherit<vsg::ReaderWriter, stbi>
     {
     public:
@@ -50,12 +90,18 @@ namespace vsgXchange
         vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
         bool getFeatures(Features& features) const override;
+        bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
+
+        // vsg::Options::setValue(str, value) supported options:
+        static constexpr const char* max_dimension = "max_dimension"; /// uint32_t, reduce images by a power of two so neither width nor height exceeds max_dimension, 0 for full resolution
 
     private:
         std::unordered_set<std::string> _supportedExtensions;
     };
 
     /// add dds support using local build of tinydds.
+    /// Uncompressed, BC1-BC7 and BC6H formats are read with a vsg::Data value type matching the DXGI format, 16 bit float components as unsigned shorts.
+    /// B8G8R8A8 images are read as VK_FORMAT_B8G8R8A8 without any conversion unless the bgra_to_rgba option is set.
     class VSGXCHANGE_DECLSPEC dds : public vsg::Inherit<vsg::ReaderWriter, dds>
     {
     public:
@@ -66,12 +112,17 @@ namespace vsgXchange
         vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
         bool getFeatures(Features& features) const override;
+        bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
+
+        // vsg::Options::setValue(str, value) supported options:
+        static constexpr const char* bgra_to_rgba = "bgra_to_rgba"; /// bool, swizzle B8G8R8A8 images to R8G8B8A8 while they are copied into the vsg::Data, for consumers that only handle RGBA
 
     private:
         std::unordered_set<std::string> _supportedExtensions;
     };
 
     /// add ktx using using local build of libktx
+    /// When built with vsgXchange_basisu, Basis Universal ETC1S and UASTC KTX2 textures are transcoded to the GPU format selected by the transcode_format option.
     class VSGXCHANGE_DECLSPEC ktx : public vsg::Inherit<vsg::ReaderWriter, ktx>
     {
     public:
@@ -82,12 +133,18 @@ namespace vsgXchange
         vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
 
         bool getFeatures(Features& features) const override;
+        bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
+
+        // vsg::Options::setValue(str, value) supported options:
+        static constexpr const char* transcode_format = "transcode_format"; /// std::string, format ETC1S and UASTC textures are transcoded to, "bc7" (default), "bc3", "bc1" (no alpha), "astc" (4x4) or "rgba8"
+        static constexpr const char* max_threads = "max_threads"; /// uint32_t, maximum number of threads used to transcode the levels, layers and faces of a texture or inflate its zstd supercompressed levels, 0 selects std::thread::hardware_concurrency()
 
     private:
         std::unordered_set<std::string> _supportedExtensions;
     };
 
     /// optional GDAL ReaderWriter
+    /// Plain texture formats read by stbi, dds and ktx are left to them unless accompanied by a world file or .aux.xml georeferencing side car file.
     class VSGXCHANGE_DECLSPEC GDAL : public vsg::Inherit<vsg::ReaderWriter, GDAL>
     {
     public:
@@ -110,3 +167,4 @@ EVSG_type_name(vsgXchange::stbi);
 EVSG_type_name(vsgXchange::dds);
 EVSG_type_name(vsgXchange::ktx);
 EVSG_type_name(vsgXchange::GDAL);
+EVSG_type_name(vsgXchange::ImageInfo);
@@ -21,6 +21,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/VSG.h>
 #include <vsg/io/spirv.h>
 
+#include "../utils/Signature.h"
+
 using namespace vsgXchange;
 
 all::all()
@@ -55,3 +57,13 @@ all::all()
     add(OSG::create());
 #endif
 }
+
+vsg::ref_ptr<vsg::Object> all::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+{
+    return CompositeReaderWriter::read(fin, optionsWithSignatureHint(fin, options));
+}
+
+vsg::ref_ptr<vsg::Object> all::read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options) const
+{
+    return CompositeReaderWriter::read(ptr, size, optionsWithSignatureHint(ptr, size, options));
+}
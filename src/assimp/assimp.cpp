@@ -16,6 +16,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "shaders/assimp_pbr_frag.cpp"
 #include "shaders/assimp_phong_frag.cpp"
 
+#include "../utils/InputBuffer.h"
+
 #include <cmath>
 #include <sstream>
 #include <stack>
@@ -896,15 +898,7 @@ vsg::ref_ptr<vsg::Object> assimp::Implementation::read(std::istream& fin, vsg::r
     Assimp::Importer importer;
     if (importer.IsExtensionSupported(options->extensionHint))
     {
-        std::string buffer(1 << 16, 0); // 64kB
-        std::string input;
-
-        while (!fin.eof())
-        {
-            fin.read(&buffer[0], buffer.size());
-            const auto bytes_readed = fin.gcount();
-            input.append(&buffer[0], bytes_readed);
-        }
+        InputBuffer input(fin);
 
         if (auto scene = importer.ReadFileFromMemory(input.data(), input.size(), _importFlags); scene)
         {
@@ -13,9 +13,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsgXchange/images.h>
 
 #include <vsg/io/FileSystem.h>
+
+#include "../utils/InputBuffer.h"
+#include "../utils/MappedFile.h"
+#include "../utils/PixelConversion.h"
 #include <vsg/io/ObjectCache.h>
 
+#include <algorithm>
 #include <cstring>
+#include <fstream>
 
 #if defined(__GNUC__)
 #    pragma GCC diagnostic push
@@ -34,34 +40,143 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 namespace
 {
-    const std::unordered_map<tinyddsloader::DDSFile::DXGIFormat, VkFormat> kFormatMap{
-        {tinyddsloader::DDSFile::DXGIFormat::R8G8B8A8_UNorm, VK_FORMAT_R8G8B8A8_UNORM},
-        {tinyddsloader::DDSFile::DXGIFormat::R8G8B8A8_SNorm, VK_FORMAT_R8G8B8A8_SNORM},
-        {tinyddsloader::DDSFile::DXGIFormat::R8G8B8A8_UNorm_SRGB, VK_FORMAT_R8G8B8A8_SRGB},
-        {tinyddsloader::DDSFile::DXGIFormat::BC7_UNorm, VK_FORMAT_BC7_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC7_UNorm_SRGB, VK_FORMAT_BC7_SRGB_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC5_UNorm, VK_FORMAT_BC5_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC5_SNorm, VK_FORMAT_BC5_SNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC4_UNorm, VK_FORMAT_BC4_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC4_SNorm, VK_FORMAT_BC4_SNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC3_UNorm, VK_FORMAT_BC3_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC3_UNorm_SRGB, VK_FORMAT_BC3_SRGB_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC2_UNorm, VK_FORMAT_BC2_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC2_UNorm_SRGB, VK_FORMAT_BC2_SRGB_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC1_UNorm, VK_FORMAT_BC1_RGBA_UNORM_BLOCK},
-        {tinyddsloader::DDSFile::DXGIFormat::BC1_UNorm_SRGB, VK_FORMAT_BC1_RGBA_SRGB_BLOCK}};
-
-    uint8_t* allocateAndCopyToContiguousBlock(tinyddsloader::DDSFile& ddsFile)
+    using DXGIFormat = tinyddsloader::DDSFile::DXGIFormat;
+
+    template<typename T>
+    vsg::ref_ptr<vsg::Data> createImage(uint32_t arrayDimensions, uint32_t width, uint32_t height, uint32_t depth, uint8_t* data, vsg::Data::Layout layout)
+    {
+        switch (arrayDimensions)
+        {
+        case 1: return vsg::Array<T>::create(width, reinterpret_cast<T*>(data), layout);
+        case 2: return vsg::Array2D<T>::create(width, height, reinterpret_cast<T*>(data), layout);
+        case 3: return vsg::Array3D<T>::create(width, height, depth, reinterpret_cast<T*>(data), layout);
+        default: return {};
+        }
+    }
+
+    /// VkFormat and vsg::Data value type that a DXGI format is read as.
+    struct DdsFormat
+    {
+        VkFormat format;
+        vsg::ref_ptr<vsg::Data> (*create)(uint32_t arrayDimensions, uint32_t width, uint32_t height, uint32_t depth, uint8_t* data, vsg::Data::Layout layout);
+        bool opaque = false; /// alpha component is unused so is set to 255 when read
+    };
+
+    // 16 bit float components are held as uint16_t/usvec as VSG has no half float type.
+    const std::unordered_map<DXGIFormat, DdsFormat> kFormatMap{
+        {DXGIFormat::R32G32B32A32_Float, {VK_FORMAT_R32G32B32A32_SFLOAT, createImage<vsg::vec4>}},
+        {DXGIFormat::R32G32B32A32_UInt, {VK_FORMAT_R32G32B32A32_UINT, createImage<vsg::uivec4>}},
+        {DXGIFormat::R32G32B32A32_SInt, {VK_FORMAT_R32G32B32A32_SINT, createImage<vsg::ivec4>}},
+        {DXGIFormat::R32G32B32_Float, {VK_FORMAT_R32G32B32_SFLOAT, createImage<vsg::vec3>}},
+        {DXGIFormat::R32G32B32_UInt, {VK_FORMAT_R32G32B32_UINT, createImage<vsg::uivec3>}},
+        {DXGIFormat::R32G32B32_SInt, {VK_FORMAT_R32G32B32_SINT, createImage<vsg::ivec3>}},
+        {DXGIFormat::R16G16B16A16_Float, {VK_FORMAT_R16G16B16A16_SFLOAT, createImage<vsg::usvec4>}},
+        {DXGIFormat::R16G16B16A16_UNorm, {VK_FORMAT_R16G16B16A16_UNORM, createImage<vsg::usvec4>}},
+        {DXGIFormat::R16G16B16A16_UInt, {VK_FORMAT_R16G16B16A16_UINT, createImage<vsg::usvec4>}},
+        {DXGIFormat::R16G16B16A16_SNorm, {VK_FORMAT_R16G16B16A16_SNORM, createImage<vsg::svec4>}},
+        {DXGIFormat::R16G16B16A16_SInt, {VK_FORMAT_R16G16B16A16_SINT, createImage<vsg::svec4>}},
+        {DXGIFormat::R32G32_Float, {VK_FORMAT_R32G32_SFLOAT, createImage<vsg::vec2>}},
+        {DXGIFormat::R32G32_UInt, {VK_FORMAT_R32G32_UINT, createImage<vsg::uivec2>}},
+        {DXGIFormat::R32G32_SInt, {VK_FORMAT_R32G32_SINT, createImage<vsg::ivec2>}},
+        {DXGIFormat::R10G10B10A2_UNorm, {VK_FORMAT_A2B10G10R10_UNORM_PACK32, createImage<uint32_t>}},
+        {DXGIFormat::R10G10B10A2_UInt, {VK_FORMAT_A2B10G10R10_UINT_PACK32, createImage<uint32_t>}},
+        {DXGIFormat::R11G11B10_Float, {VK_FORMAT_B10G11R11_UFLOAT_PACK32, createImage<uint32_t>}},
+        {DXGIFormat::R8G8B8A8_UNorm, {VK_FORMAT_R8G8B8A8_UNORM, createImage<vsg::ubvec4>}},
+        {DXGIFormat::R8G8B8A8_UNorm_SRGB, {VK_FORMAT_R8G8B8A8_SRGB, createImage<vsg::ubvec4>}},
+        {DXGIFormat::R8G8B8A8_UInt, {VK_FORMAT_R8G8B8A8_UINT, createImage<vsg::ubvec4>}},
+        {DXGIFormat::R8G8B8A8_SNorm, {VK_FORMAT_R8G8B8A8_SNORM, createImage<vsg::bvec4>}},
+        {DXGIFormat::R8G8B8A8_SInt, {VK_FORMAT_R8G8B8A8_SINT, createImage<vsg::bvec4>}},
+        {DXGIFormat::R16G16_Float, {VK_FORMAT_R16G16_SFLOAT, createImage<vsg::usvec2>}},
+        {DXGIFormat::R16G16_UNorm, {VK_FORMAT_R16G16_UNORM, createImage<vsg::usvec2>}},
+        {DXGIFormat::R16G16_UInt, {VK_FORMAT_R16G16_UINT, createImage<vsg::usvec2>}},
+        {DXGIFormat::R16G16_SNorm, {VK_FORMAT_R16G16_SNORM, createImage<vsg::svec2>}},
+        {DXGIFormat::R16G16_SInt, {VK_FORMAT_R16G16_SINT, createImage<vsg::svec2>}},
+        {DXGIFormat::D32_Float, {VK_FORMAT_D32_SFLOAT, createImage<float>}},
+        {DXGIFormat::R32_Float, {VK_FORMAT_R32_SFLOAT, createImage<float>}},
+        {DXGIFormat::R32_UInt, {VK_FORMAT_R32_UINT, createImage<uint32_t>}},
+        {DXGIFormat::R32_SInt, {VK_FORMAT_R32_SINT, createImage<int32_t>}},
+        {DXGIFormat::R8G8_UNorm, {VK_FORMAT_R8G8_UNORM, createImage<vsg::ubvec2>}},
+        {DXGIFormat::R8G8_UInt, {VK_FORMAT_R8G8_UINT, createImage<vsg::ubvec2>}},
+        {DXGIFormat::R8G8_SNorm, {VK_FORMAT_R8G8_SNORM, createImage<vsg::bvec2>}},
+        {DXGIFormat::R8G8_SInt, {VK_FORMAT_R8G8_SINT, createImage<vsg::bvec2>}},
+        {DXGIFormat::R16_Float, {VK_FORMAT_R16_SFLOAT, createImage<uint16_t>}},
+        {DXGIFormat::D16_UNorm, {VK_FORMAT_D16_UNORM, createImage<uint16_t>}},
+        {DXGIFormat::R16_UNorm, {VK_FORMAT_R16_UNORM, createImage<uint16_t>}},
+        {DXGIFormat::R16_UInt, {VK_FORMAT_R16_UINT, createImage<uint16_t>}},
+        {DXGIFormat::R16_SNorm, {VK_FORMAT_R16_SNORM, createImage<int16_t>}},
+        {DXGIFormat::R16_SInt, {VK_FORMAT_R16_SINT, createImage<int16_t>}},
+        {DXGIFormat::R8_UNorm, {VK_FORMAT_R8_UNORM, createImage<uint8_t>}},
+        {DXGIFormat::R8_UInt, {VK_FORMAT_R8_UINT, createImage<uint8_t>}},
+        {DXGIFormat::R8_SNorm, {VK_FORMAT_R8_SNORM, createImage<int8_t>}},
+        {DXGIFormat::R8_SInt, {VK_FORMAT_R8_SINT, createImage<int8_t>}},
+        {DXGIFormat::R9G9B9E5_SHAREDEXP, {VK_FORMAT_E5B9G9R9_UFLOAT_PACK32, createImage<uint32_t>}},
+        {DXGIFormat::B5G6R5_UNorm, {VK_FORMAT_R5G6B5_UNORM_PACK16, createImage<uint16_t>}},
+        {DXGIFormat::B5G5R5A1_UNorm, {VK_FORMAT_A1R5G5B5_UNORM_PACK16, createImage<uint16_t>}},
+        {DXGIFormat::B8G8R8A8_UNorm, {VK_FORMAT_B8G8R8A8_UNORM, createImage<vsg::ubvec4>}},
+        {DXGIFormat::B8G8R8A8_UNorm_SRGB, {VK_FORMAT_B8G8R8A8_SRGB, createImage<vsg::ubvec4>}},
+        {DXGIFormat::B8G8R8X8_UNorm, {VK_FORMAT_B8G8R8A8_UNORM, createImage<vsg::ubvec4>, true}},
+        {DXGIFormat::B8G8R8X8_UNorm_SRGB, {VK_FORMAT_B8G8R8A8_SRGB, createImage<vsg::ubvec4>, true}},
+        {DXGIFormat::BC1_UNorm, {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, createImage<vsg::block64>}},
+        {DXGIFormat::BC1_UNorm_SRGB, {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, createImage<vsg::block64>}},
+        {DXGIFormat::BC2_UNorm, {VK_FORMAT_BC2_UNORM_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC2_UNorm_SRGB, {VK_FORMAT_BC2_SRGB_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC3_UNorm, {VK_FORMAT_BC3_UNORM_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC3_UNorm_SRGB, {VK_FORMAT_BC3_SRGB_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC4_UNorm, {VK_FORMAT_BC4_UNORM_BLOCK, createImage<vsg::block64>}},
+        {DXGIFormat::BC4_SNorm, {VK_FORMAT_BC4_SNORM_BLOCK, createImage<vsg::block64>}},
+        {DXGIFormat::BC5_UNorm, {VK_FORMAT_BC5_UNORM_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC5_SNorm, {VK_FORMAT_BC5_SNORM_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC6H_UF16, {VK_FORMAT_BC6H_UFLOAT_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC6H_SF16, {VK_FORMAT_BC6H_SFLOAT_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC7_UNorm, {VK_FORMAT_BC7_UNORM_BLOCK, createImage<vsg::block128>}},
+        {DXGIFormat::BC7_UNorm_SRGB, {VK_FORMAT_BC7_SRGB_BLOCK, createImage<vsg::block128>}}};
+
+    /// map a DXGI format to the DdsFormat it's read as, B8G8R8A8 formats are swizzled to R8G8B8A8 when the dds::bgra_to_rgba option is set.
+    bool ddsFormat(DXGIFormat dxgiFormat, const vsg::Options* options, DdsFormat& ddsFormat, bool& swizzle)
+    {
+        auto it = kFormatMap.find(dxgiFormat);
+        if (it == kFormatMap.end()) return false;
+
+        ddsFormat = it->second;
+
+        bool bgraToRgba = false;
+        if (options) options->getValue(vsgXchange::dds::bgra_to_rgba, bgraToRgba);
+
+        swizzle = bgraToRgba && (ddsFormat.format == VK_FORMAT_B8G8R8A8_UNORM || ddsFormat.format == VK_FORMAT_B8G8R8A8_SRGB);
+        if (swizzle)
+        {
+            ddsFormat.format = (ddsFormat.format == VK_FORMAT_B8G8R8A8_UNORM) ? VK_FORMAT_R8G8B8A8_UNORM : VK_FORMAT_R8G8B8A8_SRGB;
+        }
+        return true;
+    }
+
+    /// number of the largest mipmap levels to leave out of the vsg::Data, from images::skip_mip_levels, always keeping the smallest level.
+    uint32_t firstMipLevel(tinyddsloader::DDSFile& ddsFile, const vsg::Options* options)
+    {
+        uint32_t skip = 0;
+        if (options) options->getValue(vsgXchange::images::skip_mip_levels, skip);
+        return std::min(skip, std::max(ddsFile.GetMipCount(), 1u) - 1);
+    }
+
+    /// dimension of mipmap level firstLevel
+    uint32_t mipDimension(uint32_t dimension, uint32_t firstLevel)
+    {
+        return std::max(dimension >> firstLevel, 1u);
+    }
+
+    /// copy mipmap levels firstLevel onwards into a buffer in the level major order VSG assumes, the images of the skipped levels are never read.
+    /// B8G8R8A8 pixels are swizzled to R8G8B8A8 and unused alpha components set to 255 as they are copied, so no extra pass over the image is needed.
+    uint8_t* allocateAndCopyToContiguousBlock(tinyddsloader::DDSFile& ddsFile, uint32_t firstLevel, bool swizzle, bool opaque)
     {
         const auto numMipMaps = ddsFile.GetMipCount();
         const auto numArrays = ddsFile.GetArraySize();
         size_t totalSize = 0;
-        for (uint32_t i = 0; i < numMipMaps; ++i)
+        for (uint32_t i = firstLevel; i < numMipMaps; ++i)
         {
             for (uint32_t j = 0; j < numArrays; ++j)
             {
                 const auto data = ddsFile.GetImageData(i, j);
-                totalSize += data->m_memSlicePitch;
+                totalSize += static_cast<size_t>(data->m_memSlicePitch) * data->m_depth;
             }
         }
 
@@ -70,15 +185,24 @@ namespace
         auto raw = new uint8_t[totalSize];
 
         uint8_t* image_ptr = raw;
-        for (uint32_t i = 0; i < numMipMaps; ++i)
+        for (uint32_t i = firstLevel; i < numMipMaps; ++i)
         {
             for (uint32_t j = 0; j < numArrays; ++j)
             {
                 const auto data = ddsFile.GetImageData(i, j);
+                const size_t imageSize = static_cast<size_t>(data->m_memSlicePitch) * data->m_depth;
 
-                std::memcpy(image_ptr, data->m_mem, data->m_memSlicePitch);
+                if (swizzle)
+                    vsgXchange::swapRedBlue(static_cast<const uint8_t*>(data->m_mem), image_ptr, imageSize / 4, 4);
+                else
+                    std::memcpy(image_ptr, data->m_mem, imageSize);
 
-                image_ptr += data->m_memSlicePitch;
+                if (opaque)
+                {
+                    for (size_t a = 3; a < imageSize; a += 4) image_ptr[a] = 255;
+                }
+
+                image_ptr += imageSize;
             }
         }
         return raw;
@@ -88,141 +212,116 @@ namespace
     {
         switch (ddsFile.GetTextureDimension())
         {
-        case tinyddsloader::DDSFile::TextureDimension::Texture1D: return VK_IMAGE_VIEW_TYPE_1D;
+        case tinyddsloader::DDSFile::TextureDimension::Texture1D: return (ddsFile.GetArraySize() > 1) ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
         case tinyddsloader::DDSFile::TextureDimension::Texture2D:
-            if (ddsFile.GetArraySize() > 1)
-            {
-                return ddsFile.IsCubemap() ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_2D_ARRAY;
-            }
-            else
+            if (ddsFile.IsCubemap())
             {
-                return VK_IMAGE_VIEW_TYPE_2D;
+                // tinyddsloader counts the 6 faces of each cube map in the array size
+                return (ddsFile.GetArraySize() > 6) ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
             }
+            return (ddsFile.GetArraySize() > 1) ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
         case tinyddsloader::DDSFile::TextureDimension::Texture3D: return VK_IMAGE_VIEW_TYPE_3D;
         case tinyddsloader::DDSFile::TextureDimension::Unknown: return -1;
         }
         return -1;
     }
 
-    vsg::ref_ptr<vsg::Data> readCompressed(tinyddsloader::DDSFile& ddsFile, VkFormat targetFormat)
+    vsg::ref_ptr<vsg::Data> readDds(tinyddsloader::DDSFile& ddsFile, const vsg::Options* options)
     {
-        const auto width = ddsFile.GetWidth();
-        const auto height = ddsFile.GetHeight();
-        const auto numMipMaps = ddsFile.GetMipCount();
+        const auto format = ddsFile.GetFormat();
+        const auto dim = ddsFile.GetTextureDimension();
         const auto numArrays = ddsFile.GetArraySize();
 
-        auto raw = allocateAndCopyToContiguousBlock(ddsFile);
-
-        vsg::ref_ptr<vsg::Data> vsg_data;
+        DdsFormat targetFormat;
+        bool swizzle = false;
+        if (!ddsFormat(format, options, targetFormat, swizzle))
+        {
+            std::cerr << "dds::readDds() Format is not supported yet: " << (uint32_t)format << std::endl;
+            return {};
+        }
 
         vsg::Data::Layout layout;
-        layout.format = targetFormat;
-        layout.maxNumMipmaps = numMipMaps;
-        layout.blockWidth = 4;
-        layout.blockHeight = 4;
+        layout.format = targetFormat.format;
         layout.imageViewType = computeImageViewType(ddsFile);
+        if (ddsFile.IsCompressed(format))
+        {
+            layout.blockWidth = 4;
+            layout.blockHeight = 4;
+        }
+
+        // a level smaller than a block still occupies a whole block
+        const auto firstLevel = firstMipLevel(ddsFile, options);
+        layout.maxNumMipmaps = ddsFile.GetMipCount() - firstLevel;
+        const uint32_t width = (mipDimension(ddsFile.GetWidth(), firstLevel) + layout.blockWidth - 1) / layout.blockWidth;
+        uint32_t height = (mipDimension(ddsFile.GetHeight(), firstLevel) + layout.blockHeight - 1) / layout.blockHeight;
+        uint32_t depth = mipDimension(ddsFile.GetDepth(), firstLevel);
 
-        switch (targetFormat)
+        // the array layers, including the faces of cube maps, add a dimension to 1D and 2D textures
+        uint32_t arrayDimensions = 0;
+        switch (dim)
         {
-        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
-        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
-        case VK_FORMAT_BC4_SNORM_BLOCK:
-        case VK_FORMAT_BC4_UNORM_BLOCK:
-            if (numArrays > 1)
-                vsg_data = vsg::block64Array3D::create(width / layout.blockWidth, height / layout.blockHeight, numArrays, reinterpret_cast<vsg::block64*>(raw), layout);
-            else
-                vsg_data = vsg::block64Array2D::create(width / layout.blockWidth, height / layout.blockHeight, reinterpret_cast<vsg::block64*>(raw), layout);
+        case tinyddsloader::DDSFile::TextureDimension::Texture1D:
+            arrayDimensions = (numArrays > 1) ? 2 : 1;
+            height = numArrays;
             break;
-        case VK_FORMAT_BC2_UNORM_BLOCK:
-        case VK_FORMAT_BC2_SRGB_BLOCK:
-        case VK_FORMAT_BC3_UNORM_BLOCK:
-        case VK_FORMAT_BC3_SRGB_BLOCK:
-        case VK_FORMAT_BC5_UNORM_BLOCK:
-        case VK_FORMAT_BC5_SNORM_BLOCK:
-        case VK_FORMAT_BC7_UNORM_BLOCK:
-        case VK_FORMAT_BC7_SRGB_BLOCK:
-            if (numArrays > 1)
-                vsg_data = vsg::block128Array3D::create(width / layout.blockWidth, height / layout.blockHeight, numArrays, reinterpret_cast<vsg::block128*>(raw), layout);
-            else
-                vsg_data = vsg::block128Array2D::create(width / layout.blockWidth, height / layout.blockHeight, reinterpret_cast<vsg::block128*>(raw), layout);
+        case tinyddsloader::DDSFile::TextureDimension::Texture2D:
+            arrayDimensions = (numArrays > 1) ? 3 : 2;
+            depth = numArrays;
             break;
-        default:
-            std::cerr << "dds::readCompressed() Format is not supported yet: " << (uint32_t)targetFormat << std::endl;
+        case tinyddsloader::DDSFile::TextureDimension::Texture3D:
+            arrayDimensions = 3;
             break;
+        case tinyddsloader::DDSFile::TextureDimension::Unknown:
+            std::cerr << "dds::readDds() Num of dimnension (" << (uint32_t)dim << ")  is supported." << std::endl;
+            return {};
         }
 
-        return vsg_data;
+        auto raw = allocateAndCopyToContiguousBlock(ddsFile, firstLevel, swizzle, targetFormat.opaque);
+        if (!raw) return {};
+
+        return targetFormat.create(arrayDimensions, width, height, depth, raw, layout);
     }
 
-    vsg::ref_ptr<vsg::Data> readDds(tinyddsloader::DDSFile& ddsFile)
+    vsg::ref_ptr<vsgXchange::ImageInfo> probeDds(tinyddsloader::DDSFile& ddsFile, const vsg::Options* options)
     {
-        const auto width = ddsFile.GetWidth();
-        const auto height = ddsFile.GetHeight();
-        const auto depth = ddsFile.GetDepth();
-        const auto numMipMaps = ddsFile.GetMipCount();
         const auto format = ddsFile.GetFormat();
-        const auto isCompressed = ddsFile.IsCompressed(format);
-        const auto dim = ddsFile.GetTextureDimension();
-        const auto numArrays = ddsFile.GetArraySize();
-
-        // const auto valueCount = vsg::Data::computeValueCountIncludingMipmaps(width, height, depth, numMipMaps) * numArrays;
-        // const auto bpp = tinyddsloader::DDSFile::GetBitsPerPixel(format);
-        //std::cerr << "Fileinfo width: " << width << ", height: " << height << ", depth: " << depth << ", count: " << valueCount
-        //          << ", format: " << (int)format << ", bpp: " << tinyddsloader::DDSFile::GetBitsPerPixel(format)
-        //          << ", mipmaps: " << numMipMaps << ", arrays: " << numArrays
-        //          << std::boolalpha << ", cubemap: " << isCubemap << ", compressed: " << isCompressed << std::endl;
 
-        if (auto it = kFormatMap.find(format); it != kFormatMap.end())
+        DdsFormat targetFormat;
+        bool swizzle = false;
+        if (!ddsFormat(format, options, targetFormat, swizzle))
         {
-            if (isCompressed)
-            {
-                return readCompressed(ddsFile, it->second);
-            }
-            else
-            {
-                auto raw = allocateAndCopyToContiguousBlock(ddsFile);
-
-                vsg::ref_ptr<vsg::Data> vsg_data;
-
-                vsg::Data::Layout layout;
-                layout.format = it->second;
-                layout.maxNumMipmaps = numMipMaps;
-                layout.imageViewType = computeImageViewType(ddsFile);
-
-                switch (dim)
-                {
-                case tinyddsloader::DDSFile::TextureDimension::Texture1D:
-                    vsg_data = vsg::ubvec4Array::create(width, reinterpret_cast<vsg::ubvec4*>(raw), layout);
-                    break;
-                case tinyddsloader::DDSFile::TextureDimension::Texture2D:
-                    if (numArrays > 1)
-                    {
-                        vsg_data = vsg::ubvec4Array3D::create(width, height, numArrays, reinterpret_cast<vsg::ubvec4*>(raw), layout);
-                    }
-                    else
-                    {
-                        vsg_data = vsg::ubvec4Array2D::create(width, height, reinterpret_cast<vsg::ubvec4*>(raw), layout);
-                    }
-                    break;
-                case tinyddsloader::DDSFile::TextureDimension::Texture3D:
-                    vsg_data = vsg::ubvec4Array3D::create(width, height, depth, reinterpret_cast<vsg::ubvec4*>(raw), layout);
-                    break;
-                case tinyddsloader::DDSFile::TextureDimension::Unknown:
-                    std::cerr << "dds::readDds() Num of dimnension (" << (uint32_t)dim << ")  is supported." << std::endl;
-                    break;
-                }
+            std::cerr << "dds::probeDds() Format is not supported yet: " << (uint32_t)format << std::endl;
+            return {};
+        }
 
-                //std::cout << "* Finish: " << valueCount * valueSize << ", " << vsg_data->dataSize() << std::endl;
+        const auto firstLevel = firstMipLevel(ddsFile, options);
 
-                return vsg_data;
-            }
-        }
-        else
+        auto info = vsgXchange::ImageInfo::create();
+        info->layout.format = targetFormat.format;
+        info->layout.maxNumMipmaps = ddsFile.GetMipCount() - firstLevel;
+        info->layout.imageViewType = computeImageViewType(ddsFile);
+        if (ddsFile.IsCompressed(format))
         {
-            std::cerr << "dds::readDds() Format is not supported yet: " << (uint32_t)format << std::endl;
+            info->layout.blockWidth = 4;
+            info->layout.blockHeight = 4;
         }
 
-        return {};
+        info->width = mipDimension(ddsFile.GetWidth(), firstLevel);
+        info->height = mipDimension(ddsFile.GetHeight(), firstLevel);
+        info->depth = mipDimension(ddsFile.GetDepth(), firstLevel);
+        info->layers = ddsFile.GetArraySize();
+        info->mipLevels = ddsFile.GetMipCount() - firstLevel;
+        return info;
+    }
+
+    vsg::ref_ptr<vsgXchange::ImageInfo> probeDds(std::istream& fin, const vsg::Options* options)
+    {
+        uint8_t header[tinyddsloader::DDSFile::HeaderSize];
+        fin.read(reinterpret_cast<char*>(header), sizeof(header));
+
+        tinyddsloader::DDSFile ddsFile;
+        if (ddsFile.LoadHeader(header, static_cast<size_t>(fin.gcount())) != tinyddsloader::Success) return {};
+        return probeDds(ddsFile, options);
     }
 } // namespace
 
@@ -241,11 +340,20 @@ vsg::ref_ptr<vsg::Object> dds::read(const vsg::Path& filename, vsg::ref_ptr<cons
     vsg::Path filenameToUse = findFile(filename, options);
     if (filenameToUse.empty()) return {};
 
+    if (vsg::value<bool>(false, images::probe, options))
+    {
+        std::ifstream fin(filenameToUse, std::ios::in | std::ios::binary);
+        return probeDds(fin, options.get());
+    }
+
+    // parse the file in place from a mapping of it so the only copy made is into the final vsg::Data,
+    // falling back to tinyddsloader's own file reading.
+    MappedFile mappedFile(filenameToUse);
     tinyddsloader::DDSFile ddsFile;
 
-    if (const auto result = ddsFile.Load(filenameToUse.c_str()); result == tinyddsloader::Success)
+    if (const auto result = mappedFile.valid() ? ddsFile.LoadView(mappedFile.data(), mappedFile.size()) : ddsFile.Load(filenameToUse.c_str()); result == tinyddsloader::Success)
     {
-        return readDds(ddsFile);
+        return readDds(ddsFile, options.get());
     }
     else
     {
@@ -268,10 +376,13 @@ vsg::ref_ptr<vsg::Object> dds::read(std::istream& fin, vsg::ref_ptr<const vsg::O
     if (!options || _supportedExtensions.count(options->extensionHint) == 0)
         return {};
 
+    if (vsg::value<bool>(false, images::probe, options)) return probeDds(fin, options.get());
+
+    InputBuffer input(fin);
     tinyddsloader::DDSFile ddsFile;
-    if (const auto result = ddsFile.Load(fin); result == tinyddsloader::Success)
+    if (const auto result = ddsFile.LoadView(input.data(), input.size()); result == tinyddsloader::Success)
     {
-        return readDds(ddsFile);
+        return readDds(ddsFile, options.get());
     }
     else
     {
@@ -295,9 +406,15 @@ vsg::ref_ptr<vsg::Object> dds::read(const uint8_t* ptr, size_t size, vsg::ref_pt
         return {};
 
     tinyddsloader::DDSFile ddsFile;
-    if (const auto result = ddsFile.Load(ptr, size); result == tinyddsloader::Success)
+    if (vsg::value<bool>(false, images::probe, options))
     {
-        return readDds(ddsFile);
+        if (ddsFile.LoadHeader(ptr, size) != tinyddsloader::Success) return {};
+        return probeDds(ddsFile, options.get());
+    }
+
+    if (const auto result = ddsFile.LoadView(ptr, size); result == tinyddsloader::Success)
+    {
+        return readDds(ddsFile, options.get());
     }
     else
     {
@@ -321,5 +438,18 @@ bool dds::getFeatures(Features& features) const
     {
         features.extensionFeatureMap[ext] = static_cast<vsg::ReaderWriter::FeatureMask>(vsg::ReaderWriter::READ_FILENAME | vsg::ReaderWriter::READ_ISTREAM | vsg::ReaderWriter::READ_MEMORY);
     }
+
+    features.optionNameTypeMap[images::probe] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::skip_mip_levels] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[dds::bgra_to_rgba] = vsg::type_name<bool>();
+
     return true;
 }
+
+bool dds::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
+{
+    bool result = arguments.readAndAssign<void>(images::probe, &options);
+    result = arguments.readAndAssign<uint32_t>(images::skip_mip_levels, &options) || result;
+    result = arguments.readAndAssign<void>(bgra_to_rgba, &options) || result;
+    return result;
+}
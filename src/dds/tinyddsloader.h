@@ -317,6 +317,15 @@ public:
     Result Load(std::istream& input);
     Result Load(const uint8_t* data, size_t size);
     Result Load(std::vector<uint8_t>&& dds);
+    // Parse data in place without copying it, the data must remain valid for the lifetime of the DDSFile
+    // and be writable if Flip() is used.
+    Result LoadView(const uint8_t* data, size_t size);
+    // Parse only the headers so the dimensions and format are available without the image data,
+    // data needs to hold at least the first HeaderSize bytes of the file. GetImageData() returns nullptr.
+    Result LoadHeader(const uint8_t* data, size_t size);
+
+    // maximum size of the magic word and headers that precede the image data.
+    static constexpr size_t HeaderSize = sizeof(uint32_t) + sizeof(Header) + sizeof(HeaderDXT10);
 
     const ImageData* GetImageData(uint32_t mipIdx = 0,
                                   uint32_t arrayIdx = 0) const {
@@ -341,6 +350,8 @@ private:
     void GetImageInfo(uint32_t w, uint32_t h, DXGIFormat fmt,
                       uint32_t* outNumBytes, uint32_t* outRowBytes,
                       uint32_t* outNumRows);
+    Result ParseHeader(const uint8_t* data, size_t size, ptrdiff_t& offset);
+    Result Parse(uint8_t* data, size_t size);
     bool FlipImage(ImageData& imageData);
     bool FlipCompressedImage(ImageData& imageData);
     void FlipCompressedImageBC1(ImageData& imageData);
@@ -768,7 +779,35 @@ Result DDSFile::Load(const uint8_t* data, size_t size) {
 Result DDSFile::Load(std::vector<uint8_t>&& dds) {
     m_dds.clear();
 
-    if (dds.size() < 4) {
+    auto result = Parse(dds.data(), dds.size());
+    if (result == Result::Success) {
+        // moving the vector retains its data so the image data pointers remain valid
+        m_dds = std::move(dds);
+    }
+    return result;
+}
+
+Result DDSFile::LoadView(const uint8_t* data, size_t size) {
+    m_dds.clear();
+
+    return Parse(const_cast<uint8_t*>(data), size);
+}
+
+Result DDSFile::LoadHeader(const uint8_t* data, size_t size) {
+    m_dds.clear();
+    m_imageDatas.clear();
+
+    ptrdiff_t offset = 0;
+    auto result = ParseHeader(data, size, offset);
+    if (result != Result::Success) {
+        m_mipCount = 0;
+        m_arraySize = 0;
+    }
+    return result;
+}
+
+Result DDSFile::ParseHeader(const uint8_t* dds, size_t size, ptrdiff_t& offset) {
+    if (size < 4) {
         return Result::ErrorSize;
     }
 
@@ -778,11 +817,11 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
         }
     }
 
-    if ((sizeof(uint32_t) + sizeof(Header)) >= dds.size()) {
+    if ((sizeof(uint32_t) + sizeof(Header)) > size) {
         return Result::ErrorSize;
     }
     auto header =
-        reinterpret_cast<const Header*>(dds.data() + sizeof(uint32_t));
+        reinterpret_cast<const Header*>(dds + sizeof(uint32_t));
 
     if (header->m_size != sizeof(Header) ||
         header->m_pixelFormat.m_size != sizeof(PixelFormat)) {
@@ -792,14 +831,14 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
     if ((header->m_pixelFormat.m_flags &
          uint32_t(PixelFormatFlagBits::FourCC)) &&
         (MakeFourCC('D', 'X', '1', '0') == header->m_pixelFormat.m_fourCC)) {
-        if ((sizeof(uint32_t) + sizeof(Header) + sizeof(HeaderDXT10)) >=
-            dds.size()) {
+        if ((sizeof(uint32_t) + sizeof(Header) + sizeof(HeaderDXT10)) >
+            size) {
             return Result::ErrorSize;
         }
         has_dxt10Header = true;
     }
-    ptrdiff_t offset = sizeof(uint32_t) + sizeof(Header) +
-                       (has_dxt10Header ? sizeof(HeaderDXT10) : 0);
+    offset = sizeof(uint32_t) + sizeof(Header) +
+             (has_dxt10Header ? sizeof(HeaderDXT10) : 0);
 
     m_height = header->m_height;
     m_width = header->m_width;
@@ -858,6 +897,7 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
                 if (m_arraySize > 1) {
                     return Result::ErrorNotSupported;
                 }
+                m_depth = std::max<uint32_t>(1, header->m_depth);
                 break;
             default:
                 return Result::ErrorNotSupported;
@@ -872,6 +912,7 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
 
         if (header->m_flags & uint32_t(HeaderFlagBits::Volume)) {
             m_texDim = TextureDimension::Texture3D;
+            m_depth = std::max<uint32_t>(1, header->m_depth);
         } else {
             auto caps2 = header->m_caps2 &
                          uint32_t(HeaderCaps2FlagBits::CubemapAllFaces);
@@ -888,9 +929,19 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
         }
     }
 
+    return Result::Success;
+}
+
+Result DDSFile::Parse(uint8_t* dds, size_t size) {
+    ptrdiff_t offset = 0;
+    auto result = ParseHeader(dds, size, offset);
+    if (result != Result::Success) {
+        return result;
+    }
+
     std::vector<ImageData> imageDatas(m_mipCount * m_arraySize);
-    uint8_t* srcBits = dds.data() + offset;
-    uint8_t* endBits = dds.data() + dds.size();
+    uint8_t* srcBits = dds + offset;
+    uint8_t* endBits = dds + size;
     uint32_t idx = 0;
     for (uint32_t j = 0; j < m_arraySize; j++) {
         uint32_t w = m_width;
@@ -919,7 +970,6 @@ Result DDSFile::Load(std::vector<uint8_t>&& dds) {
         }
     }
 
-    m_dds = std::move(dds);
     m_imageDatas = std::move(imageDatas);
 
     return Result::Success;
@@ -0,0 +1,252 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2020 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace vsgXchange;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// AtlasPacker
+//
+AtlasPacker::AtlasPacker(uint32_t in_width, uint32_t in_margin) :
+    _width(in_width),
+    _margin(in_margin),
+    _extentX(2 * in_margin),
+    _extentY(2 * in_margin)
+{
+}
+
+bool AtlasPacker::insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+{
+    // the trailing margin is included in the rectangle placed, the leading margin is provided by the previous rectangle or the atlas edge.
+    uint32_t placed_width = width + _margin;
+    uint32_t placed_height = height + _margin;
+    if (_margin + placed_width > _width) return false;
+
+    if (!place(placed_width, placed_height, x, y)) return false;
+
+    _extentX = std::max(_extentX, x + placed_width);
+    _extentY = std::max(_extentY, y + placed_height);
+    _usedArea += static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    return true;
+}
+
+std::unique_ptr<AtlasPacker> AtlasPacker::create(const std::string& method, uint32_t width, uint32_t margin)
+{
+    if (method == "shelf") return std::make_unique<ShelfPacker>(width, margin);
+    if (method == "skyline") return std::make_unique<SkylinePacker>(width, margin);
+    if (method == "maxrects") return std::make_unique<MaxRectsPacker>(width, margin);
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ShelfPacker
+//
+ShelfPacker::ShelfPacker(uint32_t in_width, uint32_t in_margin) :
+    AtlasPacker(in_width, in_margin),
+    _x(in_margin),
+    _y(in_margin),
+    _top(in_margin)
+{
+}
+
+bool ShelfPacker::place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+{
+    if ((_x + width) > _width)
+    {
+        // rectangle doesn't fit in present row so shift to next row.
+        _x = _margin;
+        _y = _top;
+    }
+
+    x = _x;
+    y = _y;
+
+    _top = std::max(_top, _y + height);
+    _x += width;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// SkylinePacker
+//
+SkylinePacker::SkylinePacker(uint32_t in_width, uint32_t in_margin) :
+    AtlasPacker(in_width, in_margin)
+{
+    _skyline.push_back(Node{in_margin, in_margin, in_width - in_margin});
+}
+
+bool SkylinePacker::fits(size_t index, uint32_t width, uint32_t& y) const
+{
+    if (_skyline[index].x + width > _width) return false;
+
+    // the rectangle rests on the highest of the nodes it spans
+    y = _skyline[index].y;
+    int64_t width_left = width;
+    for (size_t i = index; width_left > 0 && i < _skyline.size(); ++i)
+    {
+        y = std::max(y, _skyline[i].y);
+        width_left -= _skyline[i].width;
+    }
+    return true;
+}
+
+bool SkylinePacker::place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+{
+    // bottom-left rule, choose the position with the lowest top edge, favouring narrower steps when equal to preserve wider gaps.
+    size_t best_index = _skyline.size();
+    uint32_t best_top = std::numeric_limits<uint32_t>::max();
+    uint32_t best_width = std::numeric_limits<uint32_t>::max();
+    uint32_t best_y = 0;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        uint32_t node_y;
+        if (!fits(i, width, node_y)) continue;
+
+        uint32_t top = node_y + height;
+        if (top < best_top || (top == best_top && _skyline[i].width < best_width))
+        {
+            best_index = i;
+            best_top = top;
+            best_width = _skyline[i].width;
+            best_y = node_y;
+        }
+    }
+
+    if (best_index == _skyline.size()) return false;
+
+    x = _skyline[best_index].x;
+    y = best_y;
+
+    _skyline.insert(_skyline.begin() + best_index, Node{x, best_top, width});
+
+    // trim or remove the nodes now covered by the new node
+    for (size_t i = best_index + 1; i < _skyline.size();)
+    {
+        auto& previous = _skyline[i - 1];
+        auto& node = _skyline[i];
+        uint32_t previous_end = previous.x + previous.width;
+        if (node.x >= previous_end) break;
+
+        uint32_t shrink = previous_end - node.x;
+        if (shrink >= node.width)
+        {
+            _skyline.erase(_skyline.begin() + i);
+        }
+        else
+        {
+            node.x += shrink;
+            node.width -= shrink;
+            break;
+        }
+    }
+
+    // merge neighbouring nodes at the same height
+    for (size_t i = 1; i < _skyline.size();)
+    {
+        if (_skyline[i - 1].y == _skyline[i].y)
+        {
+            _skyline[i - 1].width += _skyline[i].width;
+            _skyline.erase(_skyline.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// MaxRectsPacker
+//
+MaxRectsPacker::MaxRectsPacker(uint32_t in_width, uint32_t in_margin) :
+    AtlasPacker(in_width, in_margin)
+{
+    // the atlas height is unbounded so start with a free rectangle taller than any atlas will be.
+    _freeRects.push_back(Rect{in_margin, in_margin, in_width - in_margin, std::numeric_limits<uint32_t>::max() / 2});
+}
+
+bool MaxRectsPacker::place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+{
+    // bottom-left rule, choose the free rectangle that gives the lowest top edge then the leftmost position.
+    const Rect* best = nullptr;
+    for (auto& rect : _freeRects)
+    {
+        if (width > rect.width || height > rect.height) continue;
+        if (!best || rect.y < best->y || (rect.y == best->y && rect.x < best->x)) best = &rect;
+    }
+
+    if (!best) return false;
+
+    x = best->x;
+    y = best->y;
+
+    split(Rect{x, y, width, height});
+
+    return true;
+}
+
+void MaxRectsPacker::split(const Rect& used)
+{
+    std::vector<Rect> newRects;
+    size_t numRemaining = 0;
+    for (auto& rect : _freeRects)
+    {
+        if (used.x >= rect.x + rect.width || used.x + used.width <= rect.x || used.y >= rect.y + rect.height || used.y + used.height <= rect.y)
+        {
+            _freeRects[numRemaining++] = rect;
+            continue;
+        }
+
+        // replace the intersected free rectangle with the maximal rectangles either side of the used rectangle.
+        if (used.x > rect.x) newRects.push_back(Rect{rect.x, rect.y, used.x - rect.x, rect.height});
+        if (used.x + used.width < rect.x + rect.width) newRects.push_back(Rect{used.x + used.width, rect.y, rect.x + rect.width - (used.x + used.width), rect.height});
+        if (used.y > rect.y) newRects.push_back(Rect{rect.x, rect.y, rect.width, used.y - rect.y});
+        if (used.y + used.height < rect.y + rect.height) newRects.push_back(Rect{rect.x, used.y + used.height, rect.width, rect.y + rect.height - (used.y + used.height)});
+    }
+    _freeRects.resize(numRemaining);
+
+    prune(newRects);
+}
+
+void MaxRectsPacker::prune(const std::vector<Rect>& newRects)
+{
+    // the remaining free rectangles are maximal so none of them can be contained within a rectangle split from another free rectangle,
+    // only the new rectangles need testing, against the remaining free rectangles and each other, keeping the first of any duplicates.
+    size_t numRemaining = _freeRects.size();
+    for (size_t i = 0; i < newRects.size(); ++i)
+    {
+        auto& rect = newRects[i];
+
+        bool contained = false;
+        for (size_t j = 0; !contained && j < numRemaining; ++j)
+        {
+            contained = _freeRects[j].contains(rect);
+        }
+
+        for (size_t j = 0; !contained && j < newRects.size(); ++j)
+        {
+            contained = (j != i) && newRects[j].contains(rect) && (j < i || !rect.contains(newRects[j]));
+        }
+
+        if (!contained) _freeRects.push_back(rect);
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2020 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vsgXchange
+{
+
+    /// Base class for placing glyph rectangles in an atlas of fixed width and unbounded height.
+    /// Each rectangle is separated from its neighbours and the atlas edges by margin texels.
+    class AtlasPacker
+    {
+    public:
+        AtlasPacker(uint32_t in_width, uint32_t in_margin);
+        virtual ~AtlasPacker() {}
+
+        /// place a width x height rectangle, returning false if it is too wide to fit within the atlas width.
+        bool insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+
+        /// atlas width that the packer places rectangles within
+        uint32_t width() const { return _width; }
+
+        /// margin placed around each rectangle
+        uint32_t margin() const { return _margin; }
+
+        /// extents of the atlas required to hold the rectangles placed so far, including the trailing margin.
+        uint32_t extentX() const { return _extentX; }
+        uint32_t extentY() const { return _extentY; }
+
+        /// area of the rectangles placed so far, excluding margins.
+        uint64_t usedArea() const { return _usedArea; }
+
+        /// create a packer, method can be "shelf", "skyline" or "maxrects", returns nullptr if the method isn't recognized.
+        static std::unique_ptr<AtlasPacker> create(const std::string& method, uint32_t width, uint32_t margin);
+
+    protected:
+        /// place a rectangle that includes the trailing margin within the region from (margin, margin) to (width, infinity).
+        virtual bool place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) = 0;
+
+        uint32_t _width;
+        uint32_t _margin;
+        uint32_t _extentX;
+        uint32_t _extentY;
+        uint64_t _usedArea = 0;
+    };
+
+    /// rows of rectangles, moving to a new row above the tallest rectangle of the current row when a rectangle doesn't fit.
+    /// Inserting rectangles in order of height minimizes the space wasted above the shorter rectangles of each row.
+    class ShelfPacker : public AtlasPacker
+    {
+    public:
+        ShelfPacker(uint32_t in_width, uint32_t in_margin);
+
+    protected:
+        bool place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) override;
+
+        uint32_t _x;
+        uint32_t _y;
+        uint32_t _top;
+    };
+
+    /// bottom-left skyline packer, tracks the top edge of the placed rectangles so rectangles can fill the steps left between rows.
+    class SkylinePacker : public AtlasPacker
+    {
+    public:
+        SkylinePacker(uint32_t in_width, uint32_t in_margin);
+
+    protected:
+        bool place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) override;
+
+        struct Node
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        /// y position a rectangle of the given width would be placed at if starting at node index, or false if it doesn't fit.
+        bool fits(size_t index, uint32_t width, uint32_t& y) const;
+
+        std::vector<Node> _skyline;
+    };
+
+    /// maximal rectangles packer, tracks all the maximal free rectangles so rectangles can fill any gap they fit in.
+    /// Gives the tightest packing at the cost of placement time that grows with the number of free rectangles.
+    class MaxRectsPacker : public AtlasPacker
+    {
+    public:
+        MaxRectsPacker(uint32_t in_width, uint32_t in_margin);
+
+    protected:
+        bool place(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) override;
+
+        struct Rect
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+            uint32_t height;
+
+            bool contains(const Rect& rhs) const { return rhs.x >= x && rhs.y >= y && (rhs.x + rhs.width) <= (x + width) && (rhs.y + rhs.height) <= (y + height); }
+        };
+
+        /// replace the free rectangles that intersect the used rectangle with the maximal free rectangles around it.
+        void split(const Rect& used);
+
+        /// add the new free rectangles that aren't contained within another free rectangle.
+        void prune(const std::vector<Rect>& newRects);
+
+        std::vector<Rect> _freeRects;
+    };
+
+} // namespace vsgXchange
@@ -7,6 +7,7 @@ endif()
 
 if(${vsgXchange_freetype})
     set(SOURCES ${SOURCES}
+        freetype/AtlasPacker.cpp
         freetype/freetype.cpp
     )
     set(EXTRA_INCLUDES ${EXTRA_INCLUDES} ${FREETYPE_INCLUDE_DIRS})
@@ -12,19 +12,33 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsgXchange/freetype.h>
 
+#include "../utils/Parallel.h"
+#include "AtlasPacker.h"
+
 #include <vsg/core/Exception.h>
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/read.h>
+#include <vsg/io/write.h>
 #include <vsg/nodes/Geometry.h>
 #include <vsg/nodes/Group.h>
 #include <vsg/state/ShaderStage.h>
 #include <vsg/text/Font.h>
+#include <vsg/utils/CommandLine.h>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_OUTLINE_H
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <thread>
 
 namespace vsgXchange
 {
@@ -52,15 +66,146 @@ namespace vsgXchange
     }
 #endif
 
+    /// Felzenszwalb & Huttenlocher's linear time 1D squared Euclidean distance transform of the sampled function f.
+    /// v and z are working arrays of size n and n+1 respectively.
+    inline void distance_transform(const float* f, float* d, int* v, float* z, int n)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = std::numeric_limits<float>::lowest();
+        z[1] = std::numeric_limits<float>::max();
+        for (int q = 1; q < n; ++q)
+        {
+            float s = ((f[q] + float(q * q)) - (f[v[k]] + float(v[k] * v[k]))) / float(2 * (q - v[k]));
+            while (s <= z[k])
+            {
+                --k;
+                s = ((f[q] + float(q * q)) - (f[v[k]] + float(v[k] * v[k]))) / float(2 * (q - v[k]));
+            }
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = std::numeric_limits<float>::max();
+        }
+
+        k = 0;
+        for (int q = 0; q < n; ++q)
+        {
+            while (z[k + 1] < float(q)) ++k;
+            float dq = float(q - v[k]);
+            d[q] = dq * dq + f[v[k]];
+        }
+    }
+
+    /// in place 2D squared Euclidean distance transform, applying the 1D transform down the columns then along the rows.
+    inline void distance_transform(std::vector<float>& grid, int width, int height)
+    {
+        int n = std::max(width, height);
+        std::vector<float> f(n), d(n), z(n + 1);
+        std::vector<int> v(n);
+
+        for (int c = 0; c < width; ++c)
+        {
+            for (int r = 0; r < height; ++r) f[r] = grid[c + r * width];
+            distance_transform(f.data(), d.data(), v.data(), z.data(), height);
+            for (int r = 0; r < height; ++r) grid[c + r * width] = d[r];
+        }
+
+        for (int r = 0; r < height; ++r)
+        {
+            float* row = grid.data() + r * width;
+            std::copy(row, row + width, f.begin());
+            distance_transform(f.data(), row, v.data(), z.data(), width);
+        }
+    }
+
+    using CharRanges = std::vector<std::pair<FT_ULong, FT_ULong>>;
+
+    /// largest valid Unicode codepoint
+    static constexpr FT_ULong max_codepoint = 0x10FFFF;
+
+    /// parse a comma separated list of codepoints and inclusive codepoint ranges, i.e. "32-126,0x400-0x4FF,0x20AC", decimal and hex values are supported.
+    /// Ranges ending beyond max_codepoint are clamped to it, codepoints or ranges starting beyond it are rejected.
+    inline bool parseCharRanges(const std::string& str, CharRanges& ranges)
+    {
+        std::stringstream sstr(str);
+        std::string item;
+        while (std::getline(sstr, item, ','))
+        {
+            if (item.find_first_not_of(" \t") == std::string::npos) continue;
+
+            try
+            {
+                size_t pos = 0;
+                FT_ULong first = std::stoul(item, &pos, 0);
+                FT_ULong last = first;
+
+                auto dash = item.find('-', pos);
+                if (dash != std::string::npos)
+                {
+                    if (item.find_first_not_of(" \t", pos) != dash) return false;
+                    size_t end_pos = 0;
+                    last = std::stoul(item.substr(dash + 1), &end_pos, 0);
+                    pos = dash + 1 + end_pos;
+                }
+
+                if (item.find_first_not_of(" \t", pos) != std::string::npos || last < first || first > max_codepoint) return false;
+
+                ranges.emplace_back(first, std::min(last, max_codepoint));
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+        }
+        return !ranges.empty();
+    }
+
+    /// 64 bit FNV-1a hash, used to key cached font atlases on the font file contents and the options used to generate them.
+    inline uint64_t fnv1a(const char* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
     class freetype::Implementation
     {
     public:
         Implementation();
 
-        void init() const;
+        /// take an FT_Library from the pool, creating a new one if none are available, so that concurrent reads don't share a library.
+        FT_Library acquireLibrary() const;
+        void releaseLibrary(FT_Library library) const;
+
+        /// return the leased FT_Library to the pool when the read completes.
+        struct LibraryLease
+        {
+            LibraryLease(const Implementation* in_implementation) :
+                implementation(in_implementation),
+                library(in_implementation->acquireLibrary()) {}
+
+            ~LibraryLease() { release(); }
+
+            void release()
+            {
+                if (library) implementation->releaseLibrary(library);
+                library = nullptr;
+            }
+
+            const Implementation* implementation;
+            FT_Library library;
+        };
 
         vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const;
 
+        /// path of the cached .vsgb for a font file under options->fileCache, keyed on the font file contents and the options that affect the atlas.
+        /// Returns an empty path if caching doesn't apply.
+        vsg::Path cachePath(const vsg::Path& filename, const vsg::Options* options) const;
+
         ~Implementation();
 
         struct Contour
@@ -71,16 +216,187 @@ namespace vsgXchange
 
         using Contours = std::list<Contour>;
 
-        unsigned char nearerst_edge(const FT_Bitmap& glyph_bitmap, int c, int r, int delta) const;
+        /// uniform grid of contour edge segments, used to limit the nearest edge search to the segments close to each texel.
+        struct EdgeGrid
+        {
+            struct Segment
+            {
+                vsg::vec2 p0;
+                vsg::vec3 edge; // normalized direction in x,y and length in z
+                uint8_t color;  // bit mask of the multi-channel distance field channels the segment contributes to
+            };
+
+            /// nearest segment found for one channel of a multi-channel distance field
+            struct ChannelNearest
+            {
+                float distance = std::numeric_limits<float>::max();
+                float orthogonality = 0.0f;
+                const Segment* segment = nullptr;
+            };
+
+            std::vector<Segment> segments;
+            std::vector<uint32_t> cellOffsets; // cellOffsets[cell] to cellOffsets[cell+1] is the range in cellSegments for that cell
+            std::vector<uint32_t> cellSegments;
+            vsg::vec2 origin;
+            float cellSize = 1.0f;
+            int numColumns = 0;
+            int numRows = 0;
+
+            /// bin the contour segments into the grid, colors optionally provides each segment's channel mask in contour order, otherwise all channels are set.
+            void build(const Contours& contours, const vsg::vec2& min_extents, const vsg::vec2& max_extents, float maxDistance, const std::vector<uint8_t>& colors = {});
+
+            /// return the distance to the nearest segment, clamped to maxDistance.
+            float nearest(const vsg::vec2& v, float maxDistance) const;
+
+            /// find the nearest segment for each of the three channels, ties at shared end points go to the segment v is most perpendicular to.
+            void nearest(const vsg::vec2& v, ChannelNearest channels[3]) const;
+        };
+
+        struct Extents
+        {
+            float min_x = std::numeric_limits<float>::max();
+            float max_x = std::numeric_limits<float>::lowest();
+            float min_y = std::numeric_limits<float>::max();
+            float max_y = std::numeric_limits<float>::lowest();
+
+            void add(const vsg::vec2& v)
+            {
+                if (v.x < min_x) min_x = v.x;
+                if (v.y < min_y) min_y = v.y;
+                if (v.x > max_x) max_x = v.x;
+                if (v.y > max_y) max_y = v.y;
+            }
+
+            bool contains(const vsg::vec2& v) const
+            {
+                return v.x >= min_x && v.x <= max_x &&
+                       v.y >= min_y && v.y <= max_y;
+            }
+        };
+
+        /// placement in the atlas and the outline or bitmap data required to compute a glyph's region of the atlas independently of FreeType.
+        struct GlyphRegion
+        {
+            unsigned int xpos = 0;
+            unsigned int ypos = 0;
+            unsigned int width = 0;
+            unsigned int height = 0;
+
+            Contours contours;
+            Extents extents;
+
+            bool useOutline = true;
+
+            // coverage bitmap, when computing a signed distance field it's supersampled and includes bitmap_margin texels around the glyph
+            unsigned int bitmap_width = 0;
+            unsigned int bitmap_rows = 0;
+            unsigned int supersample = 1;
+            int bitmap_margin = 0;
+            std::vector<unsigned char> bitmap;
+        };
+
+#if 0
+        using Atlas = vsg::byteArray2D;
+        static constexpr VkFormat atlasFormat = VK_FORMAT_R8_SNORM;
+#else
+        using Atlas = vsg::shortArray2D;
+        static constexpr VkFormat atlasFormat = VK_FORMAT_R16_SNORM;
+#endif
+        using sdf_type = Atlas::value_type;
+        static constexpr float min_value = std::numeric_limits<sdf_type>::lowest();
+        static constexpr float max_value = std::numeric_limits<sdf_type>::max();
+        static constexpr float mid_value = 0.0f;
+
+        /// parameters that control the placement of glyphs in the atlas and the glyph metrics.
+        struct AtlasSettings
+        {
+            unsigned int pixel_size = 48;
+            float freetype_pixel_size_scale = 1.0f / 64.0f;
+            unsigned int texel_margin = 12;
+            int quad_margin = 6;
+            FT_Int32 load_flags = FT_LOAD_NO_BITMAP;
+            FT_Render_Mode render_mode = FT_RENDER_MODE_NORMAL;
+            bool useOutline = true;
+            bool computeSDF = true;
+            unsigned int supersample = 2;
+            VkFormat format = atlasFormat; // R8G8B8A8_SNORM and R16G16B16A16_SNORM select a multi-channel signed distance field
+        };
+
+        /// load a glyph and collect the outline or bitmap required to compute its region of the atlas, all metrics except the uvrect are assigned.
+        bool loadGlyph(FT_Face face, FT_UInt glyph_index, const AtlasSettings& settings, GlyphRegion& region, vsg::GlyphMetrics& metrics) const;
+
+        /// compute the signed distance field for a glyph's region of the atlas, returning the number of texels computed.
+        /// Glyph regions don't overlap so may be computed concurrently.
+        size_t computeGlyphRegion(Atlas& atlas, const AtlasSettings& settings, const GlyphRegion& region) const;
+
+        /// render the glyph to a supersampled coverage bitmap that includes the margin around the glyph required by computeDistanceTransform.
+        bool rasterizeGlyph(FT_Face face, const AtlasSettings& settings, GlyphRegion& region) const;
+
+        /// compute the signed distance field for a glyph's region of the atlas from its coverage bitmap using an exact Euclidean distance transform.
+        size_t computeDistanceTransform(Atlas& atlas, const AtlasSettings& settings, const GlyphRegion& region) const;
+
+        /// compute a multi-channel signed distance field for a glyph's region of the atlas, the RGB channels hold per edge colour pseudo distances and A the true distance.
+        template<typename T>
+        size_t computeMultiChannelRegion(vsg::Array2D<vsg::t_vec4<T>>& atlas, const AtlasSettings& settings, const GlyphRegion& region) const;
+
+        /// assign red/green/blue channel masks to a contour's edges so that the channels present switch at the corners of the contour.
+        void colorEdges(const Contour& contour, std::vector<uint8_t>& colors) const;
+
+        /// create an atlas of the type required by settings.format, initialized to the minimum distance value.
+        static vsg::ref_ptr<vsg::Data> createAtlas(const AtlasSettings& settings, uint32_t width, uint32_t height);
+
+        /// compute a glyph's region of an atlas created by createAtlas.
+        size_t computeAtlasRegion(vsg::Data& atlas, const AtlasSettings& settings, const GlyphRegion& region) const;
+
+        static vsg::vec4 uvrect(const vsg::Data& atlas, const AtlasSettings& settings, unsigned int xpos, unsigned int ypos, unsigned int width, unsigned int height);
+
+        /// sorted x coordinates where the contours cross a horizontal scanline, used to classify texels along the scanline as inside/outside.
+        void scanline_intersections(const Contours& local_contours, float y, std::vector<float>& intersections) const;
+
         vsg::ref_ptr<vsg::Group> createOutlineGeometry(const Contours& contours) const;
         bool generateOutlines(FT_Outline& outline, Contours& contours) const;
         void checkForAndFixDegenerates(Contours& contours) const;
-        float nearest_contour_edge(const Contours& local_contours, const vsg::vec2& v) const;
-        bool outside_contours(const Contours& local_contours, const vsg::vec2& v) const;
 
         std::map<std::string, std::string> _supportedFormats;
         mutable std::mutex _mutex;
-        mutable FT_Library _library = nullptr;
+        mutable std::vector<FT_Library> _availableLibraries;
+    };
+
+    class DynamicFont::Implementation
+    {
+    public:
+        using AtlasSettings = freetype::Implementation::AtlasSettings;
+        using Atlas = freetype::Implementation::Atlas;
+
+        Implementation(FT_Library in_library, FT_Face in_face, const AtlasSettings& in_settings) :
+            library(in_library),
+            face(in_face),
+            settings(in_settings) {}
+
+        ~Implementation()
+        {
+            FT_Done_Face(face);
+            FT_Done_FreeType(library);
+        }
+
+        uint32_t addGlyphs(DynamicFont& font, const std::vector<uint32_t>& charcodes);
+
+        freetype::Implementation generator;
+
+        FT_Library library;
+        FT_Face face;
+        AtlasSettings settings;
+
+        mutable std::mutex mutex;
+
+        // position of each glyph in the atlas, indexed by glyph index.
+        std::vector<Region> glyphRegions;
+
+        // placement of further glyphs, continuing on from those placed when the font was read.
+        std::unique_ptr<AtlasPacker> packer;
+
+        std::vector<Region> dirtyRegions;
+        bool reallocated = false;
     };
 
 } // namespace vsgXchange
@@ -110,9 +426,32 @@ bool freetype::getFeatures(Features& features) const
     {
         features.extensionFeatureMap[ext.first] = static_cast<vsg::ReaderWriter::FeatureMask>(vsg::ReaderWriter::READ_FILENAME);
     }
+
+    features.optionNameTypeMap[freetype::max_threads] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[freetype::char_ranges] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[freetype::dynamic_atlas] = vsg::type_name<bool>();
+    features.optionNameTypeMap[freetype::collect_stats] = vsg::type_name<bool>();
+    features.optionNameTypeMap[freetype::sdf_method] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[freetype::supersample] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[freetype::pixel_size] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[freetype::packing] = vsg::type_name<std::string>();
+
     return true;
 }
 
+bool freetype::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
+{
+    bool result = arguments.readAndAssign<uint32_t>(freetype::max_threads, &options);
+    result = arguments.readAndAssign<std::string>(freetype::char_ranges, &options) || result;
+    result = arguments.readAndAssign<void>(freetype::dynamic_atlas, &options) || result;
+    result = arguments.readAndAssign<void>(freetype::collect_stats, &options) || result;
+    result = arguments.readAndAssign<std::string>(freetype::sdf_method, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(freetype::supersample, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(freetype::pixel_size, &options) || result;
+    result = arguments.readAndAssign<std::string>(freetype::packing, &options) || result;
+    return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // freetype ReaderWriter Implementation
@@ -134,99 +473,39 @@ freetype::Implementation::Implementation()
 
 freetype::Implementation::~Implementation()
 {
-    if (_library)
-    {
-        // std::cout<<"freetype::Implementation::~freetype::Implementation() FT_Done_FreeType library = "<<_library<<std::endl;
-        FT_Done_FreeType(_library);
-    }
-}
-
-void freetype::Implementation::init() const
-{
-    if (_library) return;
-
-    int error = FT_Init_FreeType(&_library);
-    if (error)
+    for (auto library : _availableLibraries)
     {
-        // std::cout<<"freetype::Implementation::init() failed."<<std::endl;
-        return;
-        //throw vsg::Exception{"FreeType an error occurred during library initialization", error};
+        FT_Done_FreeType(library);
     }
-
-    // std::cout<<"freetype::Implementation() FT_Init_FreeType library = "<<_library<<std::endl;
 }
 
-unsigned char freetype::Implementation::nearerst_edge(const FT_Bitmap& glyph_bitmap, int c, int r, int delta) const
+FT_Library freetype::Implementation::acquireLibrary() const
 {
-    unsigned char value = 0;
-    if (c >= 0 && c < static_cast<int>(glyph_bitmap.width) && r >= 0 && r < static_cast<int>(glyph_bitmap.rows))
     {
-        value = glyph_bitmap.buffer[c + r * glyph_bitmap.width];
-    }
-
-    float distance = 0.0f;
-    if (value == 0)
-    {
-        distance = float(delta);
-
-        int begin_c = (c > delta) ? (c - delta) : 0;
-        int end_c = (c + delta + 1) < static_cast<int>(glyph_bitmap.width) ? (c + delta + 1) : glyph_bitmap.width;
-        int begin_r = (r > delta) ? (r - delta) : 0;
-        int end_r = (r + delta + 1) < static_cast<int>(glyph_bitmap.rows) ? (r + delta + 1) : glyph_bitmap.rows;
-        for (int compare_r = begin_r; compare_r < end_r; ++compare_r)
+        std::scoped_lock<std::mutex> lock(_mutex);
+        if (!_availableLibraries.empty())
         {
-            for (int compare_c = begin_c; compare_c < end_c; ++compare_c)
-            {
-                unsigned char local_value = glyph_bitmap.buffer[compare_c + compare_r * glyph_bitmap.width];
-                if (local_value > 0)
-                {
-                    float local_distance = sqrt(float((compare_c - c) * (compare_c - c) + (compare_r - r) * (compare_r - r))) - float(local_value) / 255.0f + 0.5f;
-                    if (local_distance < distance) distance = local_distance;
-                }
-            }
+            auto library = _availableLibraries.back();
+            _availableLibraries.pop_back();
+            return library;
         }
-        // flip the sign to signify distance outside glyph outline
-        distance = -distance;
     }
-    else if (value == 255)
-    {
-        distance = float(delta);
 
-        int begin_c = (c > delta) ? (c - delta) : 0;
-        int end_c = (c + delta + 1) < static_cast<int>(glyph_bitmap.width) ? (c + delta + 1) : glyph_bitmap.width;
-        int begin_r = (r > delta) ? (r - delta) : 0;
-        int end_r = (r + delta + 1) < static_cast<int>(glyph_bitmap.rows) ? (r + delta + 1) : glyph_bitmap.rows;
-        for (int compare_r = begin_r; compare_r < end_r; ++compare_r)
-        {
-            for (int compare_c = begin_c; compare_c < end_c; ++compare_c)
-            {
-                unsigned char local_value = glyph_bitmap.buffer[compare_c + compare_r * glyph_bitmap.width];
-                if (local_value < 255)
-                {
-                    float local_distance = sqrt(float((compare_c - c) * (compare_c - c) + (compare_r - r) * (compare_r - r))) - float(local_value) / 255.0f + 0.5f;
-                    if (local_distance < distance) distance = local_distance;
-                }
-            }
-        }
-        // flip the sign to signify distance outside glyph outline
-        distance = distance;
-    }
-    else
+    FT_Library library = nullptr;
+    int error = FT_Init_FreeType(&library);
+    if (error)
     {
-        distance = (float(value) / 255.0f - 0.5f);
+        std::cout << "Warning: FreeType unable to initialize library, error = " << error << std::endl;
+        return nullptr;
     }
 
-    if (distance <= -float(delta))
-        return 0;
-    else if (distance >= float(delta))
-        return 255;
-    else
-    {
-        float scaled_distance = distance * (128.0f / float(delta)) + 128.0f;
-        if (scaled_distance <= 0.0f) return 0;
-        if (scaled_distance >= 255.0f) return 255;
-        return static_cast<unsigned char>(scaled_distance);
-    }
+    return library;
+}
+
+void freetype::Implementation::releaseLibrary(FT_Library library) const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _availableLibraries.push_back(library);
 }
 
 vsg::ref_ptr<vsg::Group> freetype::Implementation::createOutlineGeometry(const Contours& contours) const
@@ -428,147 +707,874 @@ void freetype::Implementation::checkForAndFixDegenerates(Contours& contours) con
     }
 }
 
-float freetype::Implementation::nearest_contour_edge(const Contours& local_contours, const vsg::vec2& v) const
+void freetype::Implementation::scanline_intersections(const Contours& local_contours, float y, std::vector<float>& intersections) const
 {
-    float min_distance = std::numeric_limits<float>::max();
+    intersections.clear();
     for (auto& contour : local_contours)
     {
         auto& points = contour.points;
-        auto& edges = contour.edges;
-        for (size_t i = 0; i < edges.size(); ++i)
+        for (size_t i = 0; i < points.size() - 1; ++i)
         {
             auto& p0 = points[i];
-            auto& edge = edges[i];
+            auto& p1 = points[i + 1];
 
-            vsg::vec2 v_p0 = v - p0;
-            float dot_v_p0 = v_p0.x * edge.x + v_p0.y * edge.y;
+            // horizontal segments never cross the scanline, and the half open test ensures shared end points are only counted once.
+            if (p0.y == p1.y || !between2(p0.y, y, p1.y)) continue;
 
-            if (dot_v_p0 < 0.0f)
+            if (p0.x == p1.x)
             {
-                float distance = vsg::length2(v - p0);
-                if (distance < min_distance) min_distance = distance;
+                intersections.push_back(p0.x);
             }
-            else if (dot_v_p0 <= edge.z)
+            else
             {
-                float d = v_p0.y * edge.x - v_p0.x * edge.y;
-                float distance = d * d;
-                if (distance < min_distance) min_distance = distance;
+                float r = (y - p0.y) / (p1.y - p0.y);
+                intersections.push_back(p0.x + (p1.x - p0.x) * r);
             }
         }
     }
-    return sqrt(min_distance);
-};
+    std::sort(intersections.begin(), intersections.end());
+}
 
-bool freetype::Implementation::outside_contours(const Contours& local_contours, const vsg::vec2& v) const
+void freetype::Implementation::EdgeGrid::build(const Contours& contours, const vsg::vec2& min_extents, const vsg::vec2& max_extents, float maxDistance, const std::vector<uint8_t>& colors)
 {
-    uint32_t numLeft = 0;
-    for (auto& contour : local_contours)
+    segments.clear();
+    std::vector<vsg::vec4> bounds;
+    for (auto& contour : contours)
     {
         auto& points = contour.points;
-        for (size_t i = 0; i < points.size() - 1; ++i)
+        auto& edges = contour.edges;
+        for (size_t i = 0; i < edges.size(); ++i)
         {
             auto& p0 = points[i];
             auto& p1 = points[i + 1];
+            uint8_t color = (segments.size() < colors.size()) ? colors[segments.size()] : 7;
+            segments.push_back(Segment{p0, edges[i], color});
+            bounds.emplace_back(std::min(p0.x, p1.x), std::min(p0.y, p1.y), std::max(p0.x, p1.x), std::max(p0.y, p1.y));
+        }
+    }
 
-            if (p0 == v || p1 == v)
-            {
-                // std::cout<<"v = "<<v<<" on end point p0="<<p0<<", p1"<<p1<<std::endl;
-                return false;
-            }
+    // size the cells so that a search out to maxDistance only has to visit a few rings of cells
+    cellSize = std::max(1.0f, maxDistance * 0.25f);
+    origin.set(min_extents.x - maxDistance, min_extents.y - maxDistance);
+    numColumns = static_cast<int>(std::ceil((max_extents.x - min_extents.x + 2.0f * maxDistance) / cellSize)) + 1;
+    numRows = static_cast<int>(std::ceil((max_extents.y - min_extents.y + 2.0f * maxDistance) / cellSize)) + 1;
+
+    auto cellRange = [&](const vsg::vec4& bound, int& c_begin, int& c_end, int& r_begin, int& r_end) {
+        c_begin = std::max(0, static_cast<int>(std::floor((bound[0] - origin.x) / cellSize)));
+        r_begin = std::max(0, static_cast<int>(std::floor((bound[1] - origin.y) / cellSize)));
+        c_end = std::min(numColumns, static_cast<int>(std::floor((bound[2] - origin.x) / cellSize)) + 1);
+        r_end = std::min(numRows, static_cast<int>(std::floor((bound[3] - origin.y) / cellSize)) + 1);
+    };
 
-            if (p0.y == p1.y) // horizontal
-            {
-                if (p0.y == v.y)
-                {
-                    // v same height as segment
-                    if (between(p0.x, v.x, p1.x))
-                    {
-                        // std::cout<<"Right on horizontal line v="<<v<<", p0 = "<<p0<<", p1 = "<<p1<<std::endl;
-                        return false;
-                    }
-                }
-            }
-            else if (p0.x == p1.x) // vertical
+    // first pass counts the segments overlapping each cell, second pass fills in the segment indices.
+    cellOffsets.assign(numColumns * numRows + 1, 0);
+    int c_begin, c_end, r_begin, r_end;
+    for (auto& bound : bounds)
+    {
+        cellRange(bound, c_begin, c_end, r_begin, r_end);
+        for (int r = r_begin; r < r_end; ++r)
+        {
+            for (int c = c_begin; c < c_end; ++c) ++cellOffsets[r * numColumns + c + 1];
+        }
+    }
+
+    for (size_t i = 1; i < cellOffsets.size(); ++i) cellOffsets[i] += cellOffsets[i - 1];
+
+    cellSegments.resize(cellOffsets.back());
+    std::vector<uint32_t> cursors(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (uint32_t s = 0; s < static_cast<uint32_t>(bounds.size()); ++s)
+    {
+        cellRange(bounds[s], c_begin, c_end, r_begin, r_end);
+        for (int r = r_begin; r < r_end; ++r)
+        {
+            for (int c = c_begin; c < c_end; ++c) cellSegments[cursors[r * numColumns + c]++] = s;
+        }
+    }
+}
+
+float freetype::Implementation::EdgeGrid::nearest(const vsg::vec2& v, float maxDistance) const
+{
+    float min_distance = maxDistance * maxDistance;
+
+    int cx = static_cast<int>(std::floor((v.x - origin.x) / cellSize));
+    int cy = static_cast<int>(std::floor((v.y - origin.y) / cellSize));
+    int maxRing = static_cast<int>(std::ceil(maxDistance / cellSize)) + 1;
+
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        // all cells in this ring are at least (ring-1) cells away from v, so once that exceeds the nearest distance found we can stop.
+        if (ring > 1)
+        {
+            float ring_distance = float(ring - 1) * cellSize;
+            if (ring_distance * ring_distance >= min_distance) break;
+        }
+
+        for (int r = cy - ring; r <= cy + ring; ++r)
+        {
+            if (r < 0 || r >= numRows) continue;
+
+            int step = (ring == 0 || r == cy - ring || r == cy + ring) ? 1 : 2 * ring;
+            for (int c = cx - ring; c <= cx + ring; c += step)
             {
-                if (between2(p0.y, v.y, p1.y))
+                if (c < 0 || c >= numColumns) continue;
+
+                int cell = r * numColumns + c;
+                for (uint32_t i = cellOffsets[cell]; i < cellOffsets[cell + 1]; ++i)
                 {
-                    if (v.x == p0.x)
+                    auto& segment = segments[cellSegments[i]];
+                    auto& p0 = segment.p0;
+                    auto& edge = segment.edge;
+
+                    vsg::vec2 v_p0 = v - p0;
+                    float dot_v_p0 = v_p0.x * edge.x + v_p0.y * edge.y;
+
+                    if (dot_v_p0 < 0.0f)
                     {
-                        // std::cout<<"Right on vertical line v="<<v<<", p0 = "<<p0<<", p1 = "<<p1<<std::endl;
-                        return false;
+                        float distance = vsg::length2(v_p0);
+                        if (distance < min_distance) min_distance = distance;
                     }
-                    else if (p0.x < v.x)
+                    else if (dot_v_p0 <= edge.z)
                     {
-                        ++numLeft;
+                        float d = v_p0.y * edge.x - v_p0.x * edge.y;
+                        float distance = d * d;
+                        if (distance < min_distance) min_distance = distance;
                     }
                 }
             }
-            else // diagonal
+        }
+    }
+    return sqrt(min_distance);
+}
+
+void freetype::Implementation::EdgeGrid::nearest(const vsg::vec2& v, ChannelNearest channels[3]) const
+{
+    int cx = static_cast<int>(std::floor((v.x - origin.x) / cellSize));
+    int cy = static_cast<int>(std::floor((v.y - origin.y) / cellSize));
+
+    // unlike the single channel search there is no distance limit, so keep going until the rings cover the whole grid.
+    int maxRing = std::max(std::max(cx, numColumns - 1 - cx), std::max(cy, numRows - 1 - cy));
+
+    for (int ring = 0; ring <= maxRing; ++ring)
+    {
+        // stop once every channel has a segment nearer than the cells in this ring, allowing for the tie tolerance.
+        if (ring > 1)
+        {
+            float furthest = std::max(std::max(channels[0].distance, channels[1].distance), channels[2].distance);
+            if (float(ring - 1) * cellSize > furthest + 1e-4f) break;
+        }
+
+        for (int r = cy - ring; r <= cy + ring; ++r)
+        {
+            if (r < 0 || r >= numRows) continue;
+
+            int step = (ring == 0 || r == cy - ring || r == cy + ring) ? 1 : 2 * ring;
+            for (int c = cx - ring; c <= cx + ring; c += step)
             {
-                if (between2(p0.y, v.y, p1.y))
+                if (c < 0 || c >= numColumns) continue;
+
+                int cell = r * numColumns + c;
+                for (uint32_t i = cellOffsets[cell]; i < cellOffsets[cell + 1]; ++i)
                 {
-                    if (v.x > p0.x && v.x > p1.x)
+                    auto& segment = segments[cellSegments[i]];
+                    auto& edge = segment.edge;
+
+                    vsg::vec2 v_p0 = v - segment.p0;
+                    float t = std::clamp(v_p0.x * edge.x + v_p0.y * edge.y, 0.0f, edge.z);
+                    vsg::vec2 v_q(v_p0.x - edge.x * t, v_p0.y - edge.y * t);
+
+                    // skip segments clearly further away than the nearest found for all of their channels, before the more costly tests.
+                    float furthest = 0.0f;
+                    for (int channel = 0; channel < 3; ++channel)
                     {
-                        // segment wholly left of v
-                        ++numLeft;
+                        if (segment.color & (1 << channel)) furthest = std::max(furthest, channels[channel].distance);
                     }
-                    else if (between(p0.x, v.x, p1.x))
+                    float limit = furthest + 2e-4f;
+                    if (vsg::length2(v_q) > limit * limit) continue;
+
+                    float distance = vsg::length(v_q);
+                    float orthogonality = (distance > 0.0f) ? std::abs(edge.x * v_q.y - edge.y * v_q.x) / distance : 1.0f;
+
+                    for (int channel = 0; channel < 3; ++channel)
                     {
-                        // segment wholly right of v
-                        // need to intersection test
-                        float r = (v.y - p0.y) / (p1.y - p0.y);
-                        float x_itersection = p0.x + (p1.x - p0.x) * r;
-                        if (x_itersection < v.x) ++numLeft;
+                        if ((segment.color & (1 << channel)) == 0) continue;
+
+                        // segments are visited in cell order, so break exact ties on the segment order to match the order the contours define.
+                        auto& n = channels[channel];
+                        if (distance < n.distance - 1e-4f ||
+                            (distance < n.distance + 1e-4f && (orthogonality > n.orthogonality || (orthogonality == n.orthogonality && &segment < n.segment))))
+                        {
+                            n.distance = distance;
+                            n.orthogonality = orthogonality;
+                            n.segment = &segment;
+                        }
                     }
                 }
             }
         }
     }
-    return (numLeft % 2) == 0;
 }
 
-vsg::ref_ptr<vsg::Object> freetype::Implementation::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+bool freetype::Implementation::loadGlyph(FT_Face face, FT_UInt glyph_index, const AtlasSettings& settings, GlyphRegion& region, vsg::GlyphMetrics& vsg_metrics) const
 {
-    auto ext = vsg::lowerCaseFileExtension(filename);
-    if (_supportedFormats.find(ext) == _supportedFormats.end())
-    {
-        return {};
-    }
+    int error = FT_Load_Glyph(face, glyph_index, settings.load_flags);
+    if (error) return false;
 
-    vsg::Path filenameToUse = findFile(filename, options);
-    if (filenameToUse.empty()) return {};
+    float freetype_pixel_size_scale = settings.freetype_pixel_size_scale;
+    float pixel_size = float(settings.pixel_size);
+    float quad_margin = float(settings.quad_margin);
 
-    std::scoped_lock<std::mutex> lock(_mutex);
+    auto metrics = face->glyph->metrics;
+    unsigned int width = static_cast<unsigned int>(ceil(float(metrics.width) * freetype_pixel_size_scale));
+    unsigned int height = static_cast<unsigned int>(ceil(float(metrics.height) * freetype_pixel_size_scale));
 
-    init();
-    if (!_library) return {};
+    region.width = width;
+    region.height = height;
 
-    FT_Face face;
-    FT_Long face_index = 0;
-    int error = FT_New_Face(_library, filenameToUse.c_str(), face_index, &face);
-    if (error == FT_Err_Unknown_File_Format)
+    // glyphs without an outline, such as those from bitmap only fonts, fall back to computing the distance field from their bitmap
+    region.useOutline = settings.useOutline && face->glyph->format == FT_GLYPH_FORMAT_OUTLINE;
+
+    if (region.useOutline)
     {
-        std::cout << "Warning: FreeType unable to read font file : " << filenameToUse << ", error = " << FT_Err_Unknown_File_Format << std::endl;
-        return {};
+        auto& contours = region.contours;
+        generateOutlines(face->glyph->outline, contours);
+
+        // scale and offset the outline geometry
+        vsg::vec2 offset(float(metrics.horiBearingX) * freetype_pixel_size_scale, float(metrics.horiBearingY) * freetype_pixel_size_scale);
+        for (auto& contour : contours)
+        {
+            for (auto& v : contour.points)
+            {
+                // scale and translate to local origin
+                v.x = v.x * freetype_pixel_size_scale - offset.x;
+                v.y = offset.y - v.y * freetype_pixel_size_scale;
+            }
+        }
+
+        // fix any degernate segments
+        checkForAndFixDegenerates(contours);
+
+        // font->setObject(vsg::make_string(glyphQuad.glyph_index), createOutlineGeometry(contours));
+
+        // compute edges and bounding volume
+        for (auto& contour : contours)
+        {
+            auto& points = contour.points;
+            for (auto& v : points)
+            {
+                region.extents.add(v);
+            }
+
+            auto& edges = contour.edges;
+            edges.resize(points.size() - 1);
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                vsg::vec2 dv = points[i + 1] - points[i];
+                float len = vsg::length(dv);
+                dv /= len;
+                edges[i].set(dv.x, dv.y, len);
+            }
+        }
     }
-    else if (error)
+    else if (settings.computeSDF)
     {
-        std::cout << "Warning: FreeType unable to read font file : " << filenameToUse << ", error = " << error << std::endl;
-        return {};
+        if (!rasterizeGlyph(face, settings, region)) return false;
     }
+    else
+    {
+        if (face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
+        {
+            error = FT_Render_Glyph(face->glyph, settings.render_mode);
+            if (error) return false;
+        }
 
-    FT_UInt pixel_size = 48;
-    FT_UInt freetype_pixel_size = pixel_size;
-    float freetype_pixel_size_scale = float(pixel_size) / (64.0f * float(freetype_pixel_size));
+        if (face->glyph->format != FT_GLYPH_FORMAT_BITMAP) return false;
 
-    {
-        error = FT_Set_Pixel_Sizes(face, freetype_pixel_size, freetype_pixel_size);
+        // take a copy of the bitmap as the glyph slot is reused by the next FT_Load_Glyph.
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        region.bitmap_width = bitmap.width;
+        region.bitmap_rows = bitmap.rows;
+        region.bitmap.resize(bitmap.width * bitmap.rows);
+        for (unsigned int r = 0; r < bitmap.rows; ++r)
+        {
+            std::memcpy(region.bitmap.data() + r * bitmap.width, bitmap.buffer + r * bitmap.pitch, bitmap.width);
+        }
     }
 
-    FT_Int32 load_flags = FT_LOAD_NO_BITMAP;
-    FT_Render_Mode render_mode = FT_RENDER_MODE_NORMAL;
+    vsg_metrics.width = float(width + 2 * settings.quad_margin) / pixel_size;
+    vsg_metrics.height = float(height + 2 * settings.quad_margin) / pixel_size;
+    vsg_metrics.horiBearingX = (float(metrics.horiBearingX) * freetype_pixel_size_scale - quad_margin) / pixel_size;
+    vsg_metrics.horiBearingY = (float(metrics.horiBearingY) * freetype_pixel_size_scale + quad_margin) / pixel_size;
+    vsg_metrics.horiAdvance = (float(metrics.horiAdvance) * freetype_pixel_size_scale) / pixel_size;
+    vsg_metrics.vertBearingX = (float(metrics.vertBearingX) * freetype_pixel_size_scale - quad_margin) / pixel_size;
+    vsg_metrics.vertBearingY = (float(metrics.vertBearingY) * freetype_pixel_size_scale + quad_margin) / pixel_size;
+    vsg_metrics.vertAdvance = (float(metrics.vertAdvance) * freetype_pixel_size_scale) / pixel_size;
+
+    return true;
+}
+
+bool freetype::Implementation::rasterizeGlyph(FT_Face face, const AtlasSettings& settings, GlyphRegion& region) const
+{
+    auto glyph = face->glyph;
+    auto& metrics = glyph->metrics;
+    float freetype_pixel_size_scale = settings.freetype_pixel_size_scale;
+    vsg::vec2 offset(float(metrics.horiBearingX) * freetype_pixel_size_scale, float(metrics.horiBearingY) * freetype_pixel_size_scale);
+
+    // the distance field is computed out to delta texels beyond the glyph, include an extra texel to sample from
+    int margin = settings.quad_margin - 1;
+    unsigned int supersample = (glyph->format == FT_GLYPH_FORMAT_OUTLINE) ? std::max(settings.supersample, 1u) : 1u;
+
+    region.supersample = supersample;
+    region.bitmap_margin = margin;
+    region.bitmap_width = (region.width + 2 * margin) * supersample;
+    region.bitmap_rows = (region.height + 2 * margin) * supersample;
+    region.bitmap.assign(region.bitmap_width * region.bitmap_rows, 0);
+
+    if (glyph->format == FT_GLYPH_FORMAT_OUTLINE)
+    {
+        FT_Outline outline;
+        int error = FT_Outline_New(glyph->library, glyph->outline.n_points, glyph->outline.n_contours, &outline);
+        if (error) return false;
+
+        FT_Outline_Copy(&glyph->outline, &outline);
+
+        // scale up by the supersample factor and translate so that the glyph's local origin is margin texels in from the top left of the bitmap.
+        float scale = freetype_pixel_size_scale * 64.0f * float(supersample);
+        FT_Matrix matrix{static_cast<FT_Fixed>(scale * 65536.0f), 0, 0, static_cast<FT_Fixed>(scale * 65536.0f)};
+        FT_Outline_Transform(&outline, &matrix);
+        FT_Outline_Translate(&outline,
+                             static_cast<FT_Pos>((float(margin) - offset.x) * float(supersample) * 64.0f),
+                             static_cast<FT_Pos>((float(region.bitmap_rows) - (offset.y + float(margin)) * float(supersample)) * 64.0f));
+
+        FT_Bitmap bitmap{};
+        bitmap.rows = region.bitmap_rows;
+        bitmap.width = region.bitmap_width;
+        bitmap.pitch = static_cast<int>(region.bitmap_width);
+        bitmap.buffer = region.bitmap.data();
+        bitmap.num_grays = 256;
+        bitmap.pixel_mode = FT_PIXEL_MODE_GRAY;
+
+        error = FT_Outline_Get_Bitmap(glyph->library, &outline, &bitmap);
+        FT_Outline_Done(glyph->library, &outline);
+
+        return error == 0;
+    }
+    else if (glyph->format == FT_GLYPH_FORMAT_BITMAP)
+    {
+        const FT_Bitmap& bitmap = glyph->bitmap;
+        if (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY && bitmap.pixel_mode != FT_PIXEL_MODE_MONO) return false;
+
+        int column_offset = margin + glyph->bitmap_left - static_cast<int>(std::lround(offset.x));
+        int row_offset = margin + static_cast<int>(std::lround(offset.y)) - glyph->bitmap_top;
+        for (unsigned int r = 0; r < bitmap.rows; ++r)
+        {
+            int row = static_cast<int>(r) + row_offset;
+            if (row < 0 || row >= static_cast<int>(region.bitmap_rows)) continue;
+
+            const unsigned char* source = bitmap.buffer + r * bitmap.pitch;
+            for (unsigned int c = 0; c < bitmap.width; ++c)
+            {
+                int column = static_cast<int>(c) + column_offset;
+                if (column < 0 || column >= static_cast<int>(region.bitmap_width)) continue;
+
+                unsigned char value = (bitmap.pixel_mode == FT_PIXEL_MODE_MONO) ? (((source[c >> 3] >> (7 - (c & 7))) & 1) ? 255 : 0) : source[c];
+                region.bitmap[column + row * region.bitmap_width] = value;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+size_t freetype::Implementation::computeDistanceTransform(Atlas& atlas, const AtlasSettings& settings, const GlyphRegion& region) const
+{
+    int bitmap_width = static_cast<int>(region.bitmap_width);
+    int bitmap_rows = static_cast<int>(region.bitmap_rows);
+    if (bitmap_width == 0 || bitmap_rows == 0) return 0;
+
+    // squared distances from each texel to the nearest texel on the other side of the glyph edge
+    const float far = 1e20f;
+    size_t size = region.bitmap.size();
+    std::vector<float> outside_distance(size);
+    std::vector<float> inside_distance(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        bool inside = region.bitmap[i] >= 128;
+        outside_distance[i] = inside ? 0.0f : far;
+        inside_distance[i] = inside ? far : 0.0f;
+    }
+
+    distance_transform(outside_distance, bitmap_width, bitmap_rows);
+    distance_transform(inside_distance, bitmap_width, bitmap_rows);
+
+    // the edge lies half way between neighbouring inside and outside texel centers, positive values are inside the glyph.
+    float texels_per_sample = 1.0f / float(region.supersample);
+    std::vector<float> signed_distance(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (region.bitmap[i] >= 128)
+            signed_distance[i] = (std::sqrt(inside_distance[i]) - 0.5f) * texels_per_sample;
+        else
+            signed_distance[i] = (0.5f - std::sqrt(outside_distance[i])) * texels_per_sample;
+    }
+
+    auto sample = [&](float u, float v) {
+        u = std::clamp(u, 0.0f, float(bitmap_width - 1));
+        v = std::clamp(v, 0.0f, float(bitmap_rows - 1));
+        int c0 = static_cast<int>(u);
+        int r0 = static_cast<int>(v);
+        int c1 = std::min(c0 + 1, bitmap_width - 1);
+        int r1 = std::min(r0 + 1, bitmap_rows - 1);
+        float fu = u - float(c0);
+        float fv = v - float(r0);
+        float top = signed_distance[c0 + r0 * bitmap_width] * (1.0f - fu) + signed_distance[c1 + r0 * bitmap_width] * fu;
+        float bottom = signed_distance[c0 + r1 * bitmap_width] * (1.0f - fu) + signed_distance[c1 + r1 * bitmap_width] * fu;
+        return top * (1.0f - fv) + bottom * fv;
+    };
+
+    float scale = 2.0f / float(settings.pixel_size);
+    int delta = settings.quad_margin - 2;
+    float supersample = float(region.supersample);
+    float margin = float(region.bitmap_margin);
+
+    unsigned int width = region.width;
+    unsigned int height = region.height;
+    for (int r = -delta; r < static_cast<int>(height + delta); ++r)
+    {
+        std::size_t index = atlas.index(region.xpos - delta, region.ypos + r);
+        for (int c = -delta; c < static_cast<int>(width + delta); ++c)
+        {
+            // sample the supersampled distance field at the texel's position relative to the glyph's local origin, as used by the outline path.
+            float min_distance = sample((float(c) + margin) * supersample - 0.5f, (float(r) + margin) * supersample - 0.5f);
+
+            float distance_ratio = (min_distance)*scale;
+            float value = mid_value + distance_ratio * (max_value - min_value);
+
+            if (value <= min_value)
+                atlas.at(index++) = static_cast<sdf_type>(min_value);
+            else if (value >= max_value)
+                atlas.at(index++) = static_cast<sdf_type>(max_value);
+            else
+                atlas.at(index++) = static_cast<sdf_type>(value);
+        }
+    }
+
+    return static_cast<size_t>(width + 2 * delta) * static_cast<size_t>(height + 2 * delta);
+}
+
+void freetype::Implementation::colorEdges(const Contour& contour, std::vector<uint8_t>& colors) const
+{
+    const uint8_t RED = 1, GREEN = 2, BLUE = 4;
+    const uint8_t YELLOW = RED | GREEN, MAGENTA = RED | BLUE, CYAN = GREEN | BLUE, WHITE = RED | GREEN | BLUE;
+
+    auto& edges = contour.edges;
+    size_t numEdges = edges.size();
+    colors.assign(numEdges, WHITE);
+    if (numEdges == 0) return;
+
+    // curves are decomposed into short line segments so only treat significant changes in direction as corners.
+    auto isCorner = [&](size_t i) {
+        auto& previous = edges[(i + numEdges - 1) % numEdges];
+        auto& next = edges[i];
+        return (previous.x * next.x + previous.y * next.y) < 0.8f;
+    };
+
+    std::vector<size_t> corners;
+    for (size_t i = 0; i < numEdges; ++i)
+    {
+        if (isCorner(i)) corners.push_back(i);
+    }
+
+    if (corners.empty())
+    {
+        // smooth contour, all channels share the same edges
+        return;
+    }
+    else if (corners.size() == 1)
+    {
+        // teardrop, split the contour into three differently coloured parts so that the single corner remains sharp.
+        const uint8_t thirds[3] = {MAGENTA, WHITE, YELLOW};
+        size_t start = corners.front();
+        for (size_t i = 0; i < numEdges; ++i)
+        {
+            colors[(start + i) % numEdges] = thirds[std::min<size_t>((i * 3) / numEdges, 2)];
+        }
+    }
+    else
+    {
+        // switch colour at each corner, making sure the last run doesn't share the colour of the first as they meet at a corner.
+        auto switchColor = [&](uint8_t color, uint8_t banned) -> uint8_t {
+            for (auto candidate : {CYAN, MAGENTA, YELLOW})
+            {
+                if (candidate != color && candidate != banned) return candidate;
+            }
+            return color;
+        };
+
+        uint8_t initialColor = CYAN;
+        uint8_t color = initialColor;
+        size_t start = corners.front();
+        size_t corner = 0;
+        for (size_t i = 0; i < numEdges; ++i)
+        {
+            size_t index = (start + i) % numEdges;
+            if (i > 0 && corner + 1 < corners.size() && index == corners[corner + 1])
+            {
+                ++corner;
+                color = switchColor(color, (corner + 1 == corners.size()) ? initialColor : color);
+            }
+            colors[index] = color;
+        }
+    }
+}
+
+template<typename T>
+size_t freetype::Implementation::computeMultiChannelRegion(vsg::Array2D<vsg::t_vec4<T>>& atlas, const AtlasSettings& settings, const GlyphRegion& region) const
+{
+    // multi-channel distance fields require the glyph outline
+    auto& contours = region.contours;
+    if (!region.useOutline || contours.empty()) return 0;
+
+    float min_value = std::numeric_limits<T>::lowest();
+    float max_value = std::numeric_limits<T>::max();
+    float mid_value = 0.0f;
+
+    float scale = 2.0f / float(settings.pixel_size);
+    int delta = settings.quad_margin - 2;
+    float max_distance = std::max(max_value - mid_value, mid_value - min_value) / ((max_value - min_value) * scale) + 1.0f;
+
+    auto toValue = [&](float distance) {
+        float value = mid_value + distance * scale * (max_value - min_value);
+        if (value <= min_value) return static_cast<T>(min_value);
+        if (value >= max_value) return static_cast<T>(max_value);
+        return static_cast<T>(value);
+    };
+
+    // the side of the edges that is inside the glyph depends on the outline orientation, take that of the largest contour.
+    std::vector<uint8_t> edgeColors;
+    std::vector<uint8_t> colors;
+    float largest_area = 0.0f;
+    for (auto& contour : contours)
+    {
+        colorEdges(contour, colors);
+        edgeColors.insert(edgeColors.end(), colors.begin(), colors.end());
+
+        float area = 0.0f;
+        auto& points = contour.points;
+        for (size_t i = 0; i < contour.edges.size(); ++i)
+        {
+            area += points[i].x * points[i + 1].y - points[i + 1].x * points[i].y;
+        }
+        if (std::abs(area) > std::abs(largest_area)) largest_area = area;
+    }
+    float inside_side = (largest_area > 0.0f) ? 1.0f : -1.0f;
+
+    EdgeGrid grid;
+    auto& extents = region.extents;
+    grid.build(contours, vsg::vec2(extents.min_x, extents.min_y), vsg::vec2(extents.max_x, extents.max_y), max_distance, edgeColors);
+
+    std::vector<float> intersections;
+
+    unsigned int width = region.width;
+    unsigned int height = region.height;
+    for (int r = -delta; r < static_cast<int>(height + delta); ++r)
+    {
+        std::size_t index = atlas.index(region.xpos - delta, region.ypos + r);
+
+        scanline_intersections(contours, float(r), intersections);
+        auto intersection_itr = intersections.begin();
+
+        for (int c = -delta; c < static_cast<int>(width + delta); ++c)
+        {
+            vsg::vec2 v(static_cast<float>(c), static_cast<float>(r));
+
+            // true signed distance, as computed for single channel distance fields
+            float true_distance = grid.nearest(v, max_distance);
+            while (intersection_itr != intersections.end() && *intersection_itr < v.x) ++intersection_itr;
+            if (((intersection_itr - intersections.begin()) % 2) == 0) true_distance = -true_distance;
+
+            // nearest edge for each channel
+            EdgeGrid::ChannelNearest nearest[3];
+            grid.nearest(v, nearest);
+
+            float channel_distance[3];
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                auto segment = nearest[channel].segment;
+                if (!segment)
+                {
+                    channel_distance[channel] = true_distance;
+                    continue;
+                }
+
+                // pseudo distance, the perpendicular distance to the edge's line extended beyond its end points, keeps the corners sharp.
+                auto& edge = segment->edge;
+                vsg::vec2 v_p0 = v - segment->p0;
+                float side = edge.x * v_p0.y - edge.y * v_p0.x;
+                float along = v_p0.x * edge.x + v_p0.y * edge.y;
+                float distance = (along < 0.0f || along > edge.z) ? std::abs(side) : nearest[channel].distance;
+                channel_distance[channel] = (side * inside_side >= 0.0f) ? distance : -distance;
+            }
+
+            // where the median of the channels disagrees with the true distance on inside/outside, fall back to the true distance.
+            float median = std::max(std::min(channel_distance[0], channel_distance[1]), std::min(std::max(channel_distance[0], channel_distance[1]), channel_distance[2]));
+            if ((median >= 0.0f) != (true_distance >= 0.0f))
+            {
+                channel_distance[0] = channel_distance[1] = channel_distance[2] = true_distance;
+            }
+
+            atlas.at(index++) = vsg::t_vec4<T>(toValue(channel_distance[0]), toValue(channel_distance[1]), toValue(channel_distance[2]), toValue(true_distance));
+        }
+    }
+
+    return static_cast<size_t>(width + 2 * delta) * static_cast<size_t>(height + 2 * delta);
+}
+
+vsg::ref_ptr<vsg::Data> freetype::Implementation::createAtlas(const AtlasSettings& settings, uint32_t width, uint32_t height)
+{
+    switch (settings.format)
+    {
+    case (VK_FORMAT_R8G8B8A8_SNORM): {
+        auto atlas = vsg::bvec4Array2D::create(width, height, vsg::Data::Layout{settings.format});
+        int8_t value = std::numeric_limits<int8_t>::lowest();
+        for (auto& c : *atlas) c.set(value, value, value, value);
+        return atlas;
+    }
+    case (VK_FORMAT_R16G16B16A16_SNORM): {
+        auto atlas = vsg::svec4Array2D::create(width, height, vsg::Data::Layout{settings.format});
+        int16_t value = std::numeric_limits<int16_t>::lowest();
+        for (auto& c : *atlas) c.set(value, value, value, value);
+        return atlas;
+    }
+    default: {
+        auto atlas = Atlas::create(width, height, vsg::Data::Layout{atlasFormat});
+
+        // initialize to zeros
+        for (auto& c : *atlas) c = static_cast<sdf_type>(min_value);
+        return atlas;
+    }
+    }
+}
+
+size_t freetype::Implementation::computeAtlasRegion(vsg::Data& atlas, const AtlasSettings& settings, const GlyphRegion& region) const
+{
+    switch (settings.format)
+    {
+    case (VK_FORMAT_R8G8B8A8_SNORM): return computeMultiChannelRegion(static_cast<vsg::bvec4Array2D&>(atlas), settings, region);
+    case (VK_FORMAT_R16G16B16A16_SNORM): return computeMultiChannelRegion(static_cast<vsg::svec4Array2D&>(atlas), settings, region);
+    default: return computeGlyphRegion(static_cast<Atlas&>(atlas), settings, region);
+    }
+}
+
+vsg::vec4 freetype::Implementation::uvrect(const vsg::Data& atlas, const AtlasSettings& settings, unsigned int xpos, unsigned int ypos, unsigned int width, unsigned int height)
+{
+    int quad_margin = settings.quad_margin;
+    return vsg::vec4(
+        (float(xpos - quad_margin) - 1.0f) / float(atlas.width() - 1), float(ypos + height + quad_margin) / float(atlas.height() - 1),
+        float(xpos + width + quad_margin) / float(atlas.width() - 1), float((ypos - quad_margin) - 1.0f) / float(atlas.height() - 1));
+}
+
+size_t freetype::Implementation::computeGlyphRegion(Atlas& atlas, const AtlasSettings& settings, const GlyphRegion& region) const
+{
+    float scale = 2.0f / float(settings.pixel_size);
+    int delta = settings.quad_margin - 2;
+
+    // beyond this distance the sdf value saturates so there is no need to search further for the nearest edge.
+    float max_distance = std::max(max_value - mid_value, mid_value - min_value) / ((max_value - min_value) * scale) + 1.0f;
+
+    unsigned int xpos = region.xpos;
+    unsigned int ypos = region.ypos;
+    unsigned int width = region.width;
+    unsigned int height = region.height;
+
+    if (region.useOutline)
+    {
+        auto& contours = region.contours;
+        auto& extents = region.extents;
+        if (contours.empty()) return 0;
+
+        EdgeGrid grid;
+        grid.build(contours, vsg::vec2(extents.min_x, extents.min_y), vsg::vec2(extents.max_x, extents.max_y), max_distance);
+
+        std::vector<float> intersections;
+
+        for (int r = -delta; r < static_cast<int>(height + delta); ++r)
+        {
+            std::size_t index = atlas.index(xpos - delta, ypos + r);
+
+            scanline_intersections(contours, float(r), intersections);
+            auto intersection_itr = intersections.begin();
+
+            for (int c = -delta; c < static_cast<int>(width + delta); ++c)
+            {
+                vsg::vec2 v;
+                v.set(float(c), float(r));
+
+                auto min_distance = grid.nearest(v, max_distance);
+
+                // an odd number of contour crossings to the left of v means v is inside the glyph.
+                while (intersection_itr != intersections.end() && *intersection_itr < v.x) ++intersection_itr;
+                if (((intersection_itr - intersections.begin()) % 2) == 0) min_distance = -min_distance;
+
+                float distance_ratio = (min_distance)*scale;
+                float value = mid_value + distance_ratio * (max_value - min_value);
+
+                if (value <= min_value)
+                    atlas.at(index++) = static_cast<sdf_type>(min_value);
+                else if (value >= max_value)
+                    atlas.at(index++) = static_cast<sdf_type>(max_value);
+                else
+                    atlas.at(index++) = static_cast<sdf_type>(value);
+            }
+        }
+
+        return static_cast<size_t>(width + 2 * delta) * static_cast<size_t>(height + 2 * delta);
+    }
+    else if (settings.computeSDF)
+    {
+        return computeDistanceTransform(atlas, settings, region);
+    }
+    else
+    {
+        const unsigned char* ptr = region.bitmap.data();
+        for (unsigned int r = 0; r < region.bitmap_rows; ++r)
+        {
+            std::size_t index = atlas.index(xpos, ypos + r);
+            for (unsigned int c = 0; c < region.bitmap_width; ++c)
+            {
+                atlas.at(index++) = *ptr++;
+            }
+        }
+        return static_cast<size_t>(region.bitmap_width) * static_cast<size_t>(region.bitmap_rows);
+    }
+}
+
+vsg::Path freetype::Implementation::cachePath(const vsg::Path& filename, const vsg::Options* options) const
+{
+    // a DynamicFont retains the FreeType face so can't be recreated from a cached atlas.
+    if (!options || options->fileCache.empty() || vsg::value<bool>(false, freetype::dynamic_atlas, options)) return {};
+
+    std::ifstream fin(filename, std::ios::in | std::ios::binary);
+    if (!fin) return {};
+
+    // hashing the contents rather than relying on timestamps ensures any change to the font file invalidates its cached atlases.
+    uint64_t hash = fnv1a(nullptr, 0);
+    std::vector<char> buffer(65536);
+    while (fin)
+    {
+        fin.read(buffer.data(), buffer.size());
+        hash = fnv1a(buffer.data(), static_cast<size_t>(fin.gcount()), hash);
+    }
+
+    // all the options that change the generated atlas, bump the version when the atlas generation itself changes.
+    std::string sdf_method("outline"), char_ranges, packing("shelf");
+    options->getValue(freetype::sdf_method, sdf_method);
+    options->getValue(freetype::char_ranges, char_ranges);
+    options->getValue(freetype::packing, packing);
+
+    std::ostringstream parameters;
+    parameters << "version=1"
+               << ";pixel_size=" << vsg::value<uint32_t>(48, freetype::pixel_size, options)
+               << ";sdf_method=" << sdf_method
+               << ";supersample=" << vsg::value<uint32_t>(2, freetype::supersample, options)
+               << ";char_ranges=" << char_ranges
+               << ";packing=" << packing;
+    auto parameters_str = parameters.str();
+    hash = fnv1a(parameters_str.data(), parameters_str.size(), hash);
+
+    std::ostringstream cacheFilename;
+    cacheFilename << vsg::simpleFilename(filename) << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".vsgb";
+    return vsg::concatPaths(vsg::concatPaths(options->fileCache, "freetype"), cacheFilename.str());
+}
+
+vsg::ref_ptr<vsg::Object> freetype::Implementation::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto ext = vsg::lowerCaseFileExtension(filename);
+    if (_supportedFormats.find(ext) == _supportedFormats.end())
+    {
+        return {};
+    }
+
+    vsg::Path filenameToUse = findFile(filename, options);
+    if (filenameToUse.empty()) return {};
+
+    using clock = std::chrono::steady_clock;
+    auto start_time = clock::now();
+
+    vsg::ref_ptr<FontStats> stats;
+    if (vsg::value<bool>(false, freetype::collect_stats, options)) stats = FontStats::create();
+
+    auto fontCachePath = cachePath(filenameToUse, options.get());
+    if (!fontCachePath.empty() && vsg::fileExists(fontCachePath))
+    {
+        if (auto font = vsg::read_cast<vsg::Font>(fontCachePath, options))
+        {
+            font->options = const_cast<vsg::Options*>(options.get());
+
+            if (stats)
+            {
+                stats->numGlyphs = font->glyphMetrics ? static_cast<uint32_t>(font->glyphMetrics->size() - 1) : 0;
+                stats->totalTime = std::chrono::duration<double>(clock::now() - start_time).count();
+                font->setObject("stats", stats);
+            }
+            return font;
+        }
+    }
+
+    LibraryLease lease(this);
+    if (!lease.library) return {};
+
+    FT_Face face;
+    FT_Long face_index = 0;
+    int error = FT_New_Face(lease.library, filenameToUse.c_str(), face_index, &face);
+    if (error == FT_Err_Unknown_File_Format)
+    {
+        std::cout << "Warning: FreeType unable to read font file : " << filenameToUse << ", error = " << FT_Err_Unknown_File_Format << std::endl;
+        return {};
+    }
+    else if (error)
+    {
+        std::cout << "Warning: FreeType unable to read font file : " << filenameToUse << ", error = " << error << std::endl;
+        return {};
+    }
+
+    AtlasSettings settings;
+    settings.pixel_size = std::max(vsg::value<uint32_t>(settings.pixel_size, freetype::pixel_size, options), 1u);
+
+    std::string sdf_method;
+    if (options && options->getValue(freetype::sdf_method, sdf_method))
+    {
+        if (sdf_method == "bitmap")
+            settings.useOutline = false;
+        else if (sdf_method == "msdf")
+            settings.format = VK_FORMAT_R8G8B8A8_SNORM;
+        else if (sdf_method == "msdf16")
+            settings.format = VK_FORMAT_R16G16B16A16_SNORM;
+        else if (sdf_method != "outline")
+            std::cout << "Warning: freetype::sdf_method value of \"" << sdf_method << "\" not recognized, using \"outline\"." << std::endl;
+    }
+    settings.supersample = vsg::value<uint32_t>(settings.supersample, freetype::supersample, options);
+
+    FT_UInt freetype_pixel_size = settings.pixel_size;
+    settings.freetype_pixel_size_scale = float(settings.pixel_size) / (64.0f * float(freetype_pixel_size));
+
+    // the distance field extends delta = quad_margin - 2 texels beyond the glyph so keep a minimum margin for small pixel sizes.
+    settings.texel_margin = std::max(settings.pixel_size / 4, 8u);
+    settings.quad_margin = settings.texel_margin / 2;
+
+    unsigned int pixel_size = settings.pixel_size;
+    float freetype_pixel_size_scale = settings.freetype_pixel_size_scale;
+    unsigned int texel_margin = settings.texel_margin;
+    FT_Int32 load_flags = settings.load_flags;
 
-    struct GlyphQuad
+    {
+        error = FT_Set_Pixel_Sizes(face, freetype_pixel_size, freetype_pixel_size);
+    }
+
+    // packing time starts once the face is open so that it excludes hashing the font file for the cache lookup and FT_New_Face.
+    auto packing_start_time = clock::now();
+
+    struct GlyphQuad
     {
         FT_ULong charcode;
         FT_ULong glyph_index;
@@ -581,8 +1587,55 @@ vsg::ref_ptr<vsg::Object> freetype::Implementation::read(const vsg::Path& filena
 
     bool hasSpace = false;
 
+    bool dynamicAtlas = vsg::value<bool>(false, freetype::dynamic_atlas, options);
+
+    CharRanges charRanges;
+    std::string char_ranges;
+    if (options && options->getValue(freetype::char_ranges, char_ranges) && !parseCharRanges(char_ranges, charRanges))
+    {
+        std::cout << "Warning: freetype::char_ranges value of \"" << char_ranges << "\" not recognized, reading all glyphs." << std::endl;
+        charRanges.clear();
+    }
+
+    // a dynamic atlas starts with just the printable ASCII characters unless told otherwise, the rest are added on demand.
+    if (dynamicAtlas && charRanges.empty()) charRanges.emplace_back(32, 126);
+
     // collect all the sizes of the glyphs
     FT_ULong max_charcode = 0;
+    if (!charRanges.empty())
+    {
+        // only look up the codepoints that have been requested rather than iterating over all the glyphs in the face,
+        // collecting them in a set first so that codepoints in overlapping ranges are only placed in the atlas once.
+        std::set<FT_ULong> charcodes;
+        for (auto& [first, last] : charRanges)
+        {
+            for (FT_ULong charcode = first; charcode <= last; ++charcode)
+            {
+                if (FT_Get_Char_Index(face, charcode) != 0) charcodes.insert(charcode);
+            }
+        }
+
+        for (auto charcode : charcodes)
+        {
+            FT_UInt glyph_index = FT_Get_Char_Index(face, charcode);
+
+            error = FT_Load_Glyph(face, glyph_index, load_flags);
+            if (error) continue;
+
+            if (charcode > max_charcode) max_charcode = charcode;
+
+            GlyphQuad quad{
+                charcode,
+                glyph_index,
+                static_cast<unsigned int>(ceil(float(face->glyph->metrics.width) * freetype_pixel_size_scale)),
+                static_cast<unsigned int>(ceil(float(face->glyph->metrics.height) * freetype_pixel_size_scale))};
+
+            if (charcode == 32) hasSpace = true;
+
+            sortedGlyphQuads.insert(quad);
+        }
+    }
+    else
     {
         FT_ULong charcode;
         FT_UInt glyph_index;
@@ -628,85 +1681,83 @@ vsg::ref_ptr<vsg::Object> freetype::Implementation::read(const vsg::Path& filena
 
                 sortedGlyphQuads.insert(quad);
 
+                if (charcode > max_charcode) max_charcode = charcode;
                 hasSpace = true;
             }
         }
     }
 
+    if (sortedGlyphQuads.empty())
+    {
+        std::cout << "Warning: FreeType found no glyphs to place in the atlas for font file : " << filenameToUse << std::endl;
+        FT_Done_Face(face);
+        return {};
+    }
+
     double total_width = 0.0;
     double total_height = 0.0;
+    unsigned int max_width = 0;
     for (auto& glyph : sortedGlyphQuads)
     {
         total_width += double(glyph.width);
         total_height += double(glyph.height);
+        max_width = std::max(max_width, glyph.width);
     }
 
     double average_width = total_width / double(sortedGlyphQuads.size());
 
-    unsigned int texel_margin = pixel_size / 4;
-    int quad_margin = texel_margin / 2;
-
-    unsigned int provisional_cells_across = static_cast<unsigned int>(ceil(sqrt(double(face->num_glyphs))));
+    // when reading a subset of the glyphs base the atlas dimensions on just the glyphs being placed
+    FT_Long num_glyphs = charRanges.empty() ? face->num_glyphs : static_cast<FT_Long>(sortedGlyphQuads.size());
+    unsigned int provisional_cells_across = static_cast<unsigned int>(ceil(sqrt(double(num_glyphs))));
     unsigned int provisional_width = provisional_cells_across * (average_width + texel_margin);
 
-    //provisional_width = 1024;
+    // leave room across the atlas for the glyphs that will be added later
+    if (dynamicAtlas) provisional_width = std::max(provisional_width, 1024u);
 
-    unsigned int xpos = texel_margin;
-    unsigned int ypos = texel_margin;
-    unsigned int xtop = 2 * texel_margin;
-    unsigned int ytop = 2 * texel_margin;
-    for (auto& glyphQuad : sortedGlyphQuads)
-    {
-        unsigned int width = glyphQuad.width;
-        unsigned int height = glyphQuad.height;
+    // make sure the widest glyph fits
+    provisional_width = std::max(provisional_width, max_width + 2 * texel_margin);
 
-        if ((xpos + width + texel_margin) > provisional_width)
-        {
-            // glyph doesn't fit in present row so shift to next row.
-            xpos = texel_margin;
-            ypos = ytop;
-        }
+    std::string packing("shelf");
+    if (options) options->getValue(freetype::packing, packing);
 
-        unsigned int local_ytop = ypos + height + texel_margin;
-        if (local_ytop > ytop) ytop = local_ytop;
+    auto packer = AtlasPacker::create(packing, provisional_width, texel_margin);
+    if (!packer)
+    {
+        std::cout << "Warning: freetype::packing value of \"" << packing << "\" not recognized, using \"shelf\"." << std::endl;
+        packing = "shelf";
+        packer = AtlasPacker::create(packing, provisional_width, texel_margin);
+    }
 
-        xpos += (width + texel_margin);
-        if (xpos > xtop) xtop = xpos;
+    // the shelf packer places glyphs in ascending height order as rows are then filled with glyphs of similar height,
+    // the other packers fill the gaps left by taller glyphs so place glyphs in descending height order.
+    std::vector<GlyphQuad> glyphQuads(sortedGlyphQuads.begin(), sortedGlyphQuads.end());
+    std::vector<std::pair<unsigned int, unsigned int>> glyphPositions(glyphQuads.size());
+    bool descendingOrder = (packing != "shelf");
+    for (size_t i = 0; i < glyphQuads.size(); ++i)
+    {
+        size_t index = descendingOrder ? (glyphQuads.size() - 1 - i) : i;
+        auto& glyphQuad = glyphQuads[index];
+        auto& position = glyphPositions[index];
+        packer->insert(glyphQuad.width, glyphQuad.height, position.first, position.second);
     }
 
-    //std::cout<<"provisional_width = "<<provisional_width<<", xtop = "<<xtop<<", ytop = "<<ytop<<std::endl;
-    //xtop = provisional_width;
+    // a dynamic atlas retains the full width so that further glyphs can be placed alongside the present ones.
+    unsigned int xtop = dynamicAtlas ? packer->width() : packer->extentX();
+    unsigned int ytop = packer->extentY();
+    uint64_t usedArea = packer->usedArea();
 
-#if 0
-    auto atlas = vsg::byteArray2D::create(xtop, ytop, vsg::Data::Layout{VK_FORMAT_R8_SNORM});
-    using sdf_type = vsg::byteArray2D::value_type;
-    float min_value = std::numeric_limits<sdf_type>::lowest();
-    float max_value = std::numeric_limits<sdf_type>::max();
-    float mid_value = 0.0f;
-#else
-    auto atlas = vsg::shortArray2D::create(xtop, ytop, vsg::Data::Layout{VK_FORMAT_R16_SNORM});
-    using sdf_type = vsg::shortArray2D::value_type;
-    float min_value = std::numeric_limits<sdf_type>::lowest();
-    float max_value = std::numeric_limits<sdf_type>::max();
-    float mid_value = 0.0f;
-#endif
+    if (stats) stats->packingTime = std::chrono::duration<double>(clock::now() - packing_start_time).count();
 
-    // initialize to zeros
-    for (auto& c : *atlas) c = static_cast<sdf_type>(min_value);
+    auto atlas = createAtlas(settings, xtop, ytop);
 
-    auto font = vsg::Font::create();
+    vsg::ref_ptr<vsg::Font> font;
+    vsg::ref_ptr<DynamicFont> dynamicFont;
+    if (dynamicAtlas)
+        font = dynamicFont = DynamicFont::create();
+    else
+        font = vsg::Font::create();
     font->atlas = atlas;
 
-    xpos = texel_margin;
-    ypos = texel_margin;
-    ytop = 0;
-
-    bool useOutline = true;
-    bool computeSDF = true;
-
-    double total_nearest_edge = 0.0;
-    double total_outside_edge = 0.0;
-
     auto glyphMetrics = vsg::GlyphMetricsArray::create(sortedGlyphQuads.size() + 1);
     auto charmap = vsg::uintArray::create(max_charcode + 1);
     uint32_t destation_glyphindex = 0;
@@ -727,199 +1778,317 @@ vsg::ref_ptr<vsg::Object> freetype::Implementation::read(const vsg::Path& filena
     // initialize charmap to zeros.
     for (auto& c : *charmap) c = 0;
 
-    for (auto& glyphQuad : sortedGlyphQuads)
+    // glyph positions are retained by a dynamic atlas so that uvrects can be recomputed when the atlas grows.
+    std::vector<DynamicFont::Region> glyphRegions(1);
+
+    // placement and outline decomposition need the FT_Face so are done serially, collecting the data required to compute
+    // each glyph's region of the atlas so that the signed distance fields can then be computed in parallel.
+    std::vector<GlyphRegion> regions;
+    regions.reserve(sortedGlyphQuads.size());
+
+    for (size_t i = 0; i < glyphQuads.size(); ++i)
+    {
+        auto& glyphQuad = glyphQuads[i];
+        GlyphRegion region;
+        vsg::GlyphMetrics vsg_metrics;
+        auto before_load = stats ? clock::now() : clock::time_point();
+        bool loaded = loadGlyph(face, glyphQuad.glyph_index, settings, region, vsg_metrics);
+        if (stats) stats->outlineTime += std::chrono::duration<double>(clock::now() - before_load).count();
+        if (!loaded) continue;
+
+        unsigned int xpos = glyphPositions[i].first;
+        unsigned int ypos = glyphPositions[i].second;
+        unsigned int width = region.width;
+        unsigned int height = region.height;
+
+        region.xpos = xpos;
+        region.ypos = ypos;
+
+        vsg_metrics.uvrect = uvrect(*atlas, settings, xpos, ypos, width, height);
+
+        glyphRegions.push_back(DynamicFont::Region{xpos, ypos, width, height});
+        regions.push_back(std::move(region));
+
+        // assign the glyph metrics and charcode/glyph_index to the VSG glyphMetrics and charmap containers.
+        glyphMetrics->set(destation_glyphindex, vsg_metrics);
+        charmap->set(glyphQuad.charcode, destation_glyphindex);
+
+        ++destation_glyphindex;
+    }
+
+    // glyphs that failed to load have no entry, so trim glyphMetrics to keep it indexed in step with glyphRegions.
+    if (destation_glyphindex < glyphMetrics->size())
+    {
+        auto loadedGlyphMetrics = vsg::GlyphMetricsArray::create(destation_glyphindex);
+        std::copy(glyphMetrics->begin(), glyphMetrics->begin() + destation_glyphindex, loadedGlyphMetrics->begin());
+        glyphMetrics = loadedGlyphMetrics;
+    }
+
+    font->ascender = float(face->ascender) * freetype_pixel_size_scale / float(pixel_size);
+    font->descender = float(face->descender) * freetype_pixel_size_scale / float(pixel_size);
+    font->height = float(face->height) * freetype_pixel_size_scale / float(pixel_size);
+    font->glyphMetrics = glyphMetrics;
+    font->charmap = charmap;
+
+    font->options = const_cast<vsg::Options*>(options.get());
+
+    if (dynamicFont)
     {
-        error = FT_Load_Glyph(face, glyphQuad.glyph_index, load_flags);
-        if (error) continue;
+        // the dynamic font takes ownership of the face and library so that it can load further glyphs.
+        auto dynamicFontImplementation = new DynamicFont::Implementation(lease.library, face, settings);
+        dynamicFontImplementation->glyphRegions = std::move(glyphRegions);
+        dynamicFontImplementation->packer = std::move(packer);
+        dynamicFont->_implementation = dynamicFontImplementation;
+        lease.library = nullptr;
+    }
+    else
+    {
+        // the remaining work doesn't require FreeType so release the face and library.
+        FT_Done_Face(face);
+        lease.release();
+    }
 
-        unsigned int width = glyphQuad.width;
-        unsigned int height = glyphQuad.height;
-        auto metrics = face->glyph->metrics;
+    std::mutex statsMutex;
+    auto computeRegion = [&](const GlyphRegion& region) {
+        if (stats)
+        {
+            auto before_compute = clock::now();
+            size_t numTexels = computeAtlasRegion(*atlas, settings, region);
+            double computeTime = std::chrono::duration<double>(clock::now() - before_compute).count();
 
-        if ((xpos + width + texel_margin) > atlas->width())
+            std::scoped_lock<std::mutex> lock(statsMutex);
+            stats->numTexels += numTexels;
+            stats->distanceTime += computeTime;
+        }
+        else
         {
-            // glyph doesn't fit in present row so shift to next row.
-            xpos = texel_margin;
-            ypos = ytop;
+            computeAtlasRegion(*atlas, settings, region);
         }
+    };
+
+    // regions are sorted by ascending height, so compute them in reverse order to start with the tallest glyphs and keep the threads busy to the end.
+    uint32_t numRegions = static_cast<uint32_t>(regions.size());
+    parallelFor(numRegions, vsg::value<uint32_t>(0, freetype::max_threads, options), [&](uint32_t i) {
+        computeRegion(regions[numRegions - 1 - i]);
+    });
 
-        if (useOutline)
+    if (!fontCachePath.empty())
+    {
+        // write to a temporary file first so that concurrent reads never see a partially written cache entry,
+        // keeping the .vsgb extension as vsg::write() selects the native writer by extension.
+        std::ostringstream temporaryPath;
+        temporaryPath << fontCachePath << "." << std::this_thread::get_id() << ".tmp.vsgb";
+
+        vsg::makeDirectory(vsg::filePath(fontCachePath));
+        if (vsg::write(font, temporaryPath.str(), options))
         {
-            Contours contours;
-            generateOutlines(face->glyph->outline, contours);
+            if (std::rename(temporaryPath.str().c_str(), fontCachePath.c_str()) != 0) std::remove(temporaryPath.str().c_str());
+        }
+        else
+        {
+            std::cout << "Warning: freetype unable to write font cache file : " << fontCachePath << std::endl;
+        }
+    }
 
-            // scale and offset the outline geometry
-            vsg::vec2 offset(float(metrics.horiBearingX) * freetype_pixel_size_scale, float(metrics.horiBearingY) * freetype_pixel_size_scale);
-            for (auto& contour : contours)
-            {
-                for (auto& v : contour.points)
-                {
-                    // scale and translate to local origin
-                    v.x = v.x * freetype_pixel_size_scale - offset.x;
-                    v.y = offset.y - v.y * freetype_pixel_size_scale;
-                }
-            }
+    if (stats)
+    {
+        stats->numGlyphs = static_cast<uint32_t>(regions.size());
+        stats->packingEfficiency = double(usedArea) / (double(atlas->width()) * double(atlas->height()));
+        stats->totalTime = std::chrono::duration<double>(clock::now() - start_time).count();
+        font->setObject("stats", stats);
+    }
 
-            // fix any degernate segments
-            checkForAndFixDegenerates(contours);
+    return font;
+}
 
-            // font->setObject(vsg::make_string(glyphQuad.glyph_index), createOutlineGeometry(contours));
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DynamicFont
+//
+DynamicFont::DynamicFont() :
+    _implementation(nullptr)
+{
+}
 
-            struct Extents
-            {
-                float min_x = std::numeric_limits<float>::max();
-                float max_x = std::numeric_limits<float>::lowest();
-                float min_y = std::numeric_limits<float>::max();
-                float max_y = std::numeric_limits<float>::lowest();
+DynamicFont::~DynamicFont()
+{
+    delete _implementation;
+}
 
-                void add(const vsg::vec2& v)
-                {
-                    if (v.x < min_x) min_x = v.x;
-                    if (v.y < min_y) min_y = v.y;
-                    if (v.x > max_x) max_x = v.x;
-                    if (v.y > max_y) max_y = v.y;
-                }
+uint32_t DynamicFont::addGlyphs(const std::vector<uint32_t>& charcodes)
+{
+    if (!_implementation) return 0;
 
-                bool contains(const vsg::vec2& v) const
-                {
-                    return v.x >= min_x && v.x <= max_x &&
-                           v.y >= min_y && v.y <= max_y;
-                }
-            } extents;
+    std::scoped_lock<std::mutex> lock(_implementation->mutex);
+    return _implementation->addGlyphs(*this, charcodes);
+}
 
-            // compute edges and bounding volume
-            for (auto& contour : contours)
-            {
-                auto& points = contour.points;
-                for (auto& v : points)
-                {
-                    extents.add(v);
-                }
+uint32_t DynamicFont::addGlyphs(const std::wstring& text)
+{
+    std::vector<uint32_t> charcodes;
+    charcodes.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        uint32_t charcode = static_cast<uint32_t>(text[i]);
 
-                auto& edges = contour.edges;
-                edges.resize(points.size() - 1);
-                for (size_t i = 0; i < edges.size(); ++i)
+        // a 16 bit wchar_t holds UTF-16, so combine surrogate pairs into the codepoints beyond the Basic Multilingual Plane.
+        if constexpr (sizeof(wchar_t) == 2)
+        {
+            if (charcode >= 0xD800 && charcode <= 0xDBFF && (i + 1) < text.size())
+            {
+                uint32_t low = static_cast<uint32_t>(text[i + 1]);
+                if (low >= 0xDC00 && low <= 0xDFFF)
                 {
-                    vsg::vec2 dv = points[i + 1] - points[i];
-                    float len = vsg::length(dv);
-                    dv /= len;
-                    edges[i].set(dv.x, dv.y, len);
+                    charcode = 0x10000 + ((charcode - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
                 }
             }
+        }
 
-            if (!contours.empty())
-            {
-                float scale = 2.0f / float(pixel_size);
-                int delta = quad_margin - 2;
-                for (int r = -delta; r < static_cast<int>(height + delta); ++r)
-                {
-                    std::size_t index = atlas->index(xpos - delta, ypos + r);
-                    for (int c = -delta; c < static_cast<int>(width + delta); ++c)
-                    {
-                        vsg::vec2 v;
-                        v.set(float(c), float(r));
+        charcodes.push_back(charcode);
+    }
+    return addGlyphs(charcodes);
+}
 
-                        auto before_nearest_edge = std::chrono::steady_clock::now();
+bool DynamicFont::hasGlyph(uint32_t charcode) const
+{
+    if (!_implementation) return false;
 
-                        auto min_distance = nearest_contour_edge(contours, v);
+    std::scoped_lock<std::mutex> lock(_implementation->mutex);
+    return charmap && charcode < charmap->size() && charmap->at(charcode) != 0;
+}
 
-                        auto after_nearest_edge = std::chrono::steady_clock::now();
+std::vector<DynamicFont::Region> DynamicFont::takeDirtyRegions(bool& reallocated)
+{
+    reallocated = false;
+    if (!_implementation) return {};
 
-                        if (!extents.contains(v) || outside_contours(contours, v)) min_distance = -min_distance;
+    std::scoped_lock<std::mutex> lock(_implementation->mutex);
+    reallocated = _implementation->reallocated;
+    _implementation->reallocated = false;
+    return std::move(_implementation->dirtyRegions);
+}
 
-                        auto after_outside_edge = std::chrono::steady_clock::now();
+uint32_t DynamicFont::Implementation::addGlyphs(DynamicFont& font, const std::vector<uint32_t>& charcodes)
+{
+    auto atlas = font.atlas;
+    if (!atlas || !font.glyphMetrics || !font.charmap) return 0;
 
-                        total_nearest_edge += std::chrono::duration<double, std::chrono::seconds::period>(after_nearest_edge - before_nearest_edge).count();
-                        total_outside_edge += std::chrono::duration<double, std::chrono::seconds::period>(after_outside_edge - after_nearest_edge).count();
+    using clock = std::chrono::steady_clock;
+    auto start_time = clock::now();
 
-                        //std::cout<<"nearest_contour_edge("<<r<<", "<<c<<") min_distance = "<<min_distance<<std::endl;
-                        float distance_ratio = (min_distance)*scale;
-                        float value = mid_value + distance_ratio * (max_value - min_value);
+    // accumulate into the stats collected when the font was read
+    auto stats = font.getObject<FontStats>("stats");
 
-                        if (value <= min_value)
-                            atlas->at(index++) = static_cast<sdf_type>(min_value);
-                        else if (value >= max_value)
-                            atlas->at(index++) = static_cast<sdf_type>(max_value);
-                        else
-                            atlas->at(index++) = static_cast<sdf_type>(value);
-                    }
-                }
-            }
-        }
-        else
-        {
-            if (face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
-            {
-                error = FT_Render_Glyph(face->glyph, render_mode);
-                if (error) continue;
-            }
+    int delta = settings.quad_margin - 2;
+
+    struct NewGlyph
+    {
+        uint32_t charcode;
+        freetype::Implementation::GlyphRegion region;
+        vsg::GlyphMetrics metrics;
+    };
+    std::vector<NewGlyph> newGlyphs;
 
-            if (face->glyph->format != FT_GLYPH_FORMAT_BITMAP) continue;
+    uint32_t max_charcode = static_cast<uint32_t>(font.charmap->size()) - 1;
+    unsigned int required_height = atlas->height();
+    for (auto charcode : charcodes)
+    {
+        if (charcode < font.charmap->size() && font.charmap->at(charcode) != 0) continue;
+        if (std::any_of(newGlyphs.begin(), newGlyphs.end(), [&](const NewGlyph& glyph) { return glyph.charcode == charcode; })) continue;
 
-            const FT_Bitmap& bitmap = face->glyph->bitmap;
+        FT_UInt glyph_index = FT_Get_Char_Index(face, charcode);
+        if (glyph_index == 0) continue;
 
-            // copy pixels
-            if (computeSDF)
-            {
-                int delta = quad_margin - 2;
-                for (int r = -delta; r < static_cast<int>(bitmap.rows + delta); ++r)
-                {
-                    std::size_t index = atlas->index(xpos - delta, ypos + r);
-                    for (int c = -delta; c < static_cast<int>(bitmap.width + delta); ++c)
-                    {
-                        atlas->at(index++) = nearerst_edge(bitmap, c, r, quad_margin);
-                    }
-                }
-            }
-            else
-            {
-                const unsigned char* ptr = bitmap.buffer;
-                for (unsigned int r = 0; r < bitmap.rows; ++r)
-                {
-                    std::size_t index = atlas->index(xpos, ypos + r);
-                    for (unsigned int c = 0; c < bitmap.width; ++c)
-                    {
-                        atlas->at(index++) = *ptr++;
-                    }
-                }
-            }
+        NewGlyph glyph{charcode, {}, {}};
+        auto before_load = stats ? clock::now() : clock::time_point();
+        bool loaded = generator.loadGlyph(face, glyph_index, settings, glyph.region, glyph.metrics);
+        if (stats) stats->outlineTime += std::chrono::duration<double>(clock::now() - before_load).count();
+        if (!loaded) continue;
+
+        auto& region = glyph.region;
+        if (!packer->insert(region.width, region.height, region.xpos, region.ypos))
+        {
+            std::cout << "Warning: DynamicFont glyph for charcode " << charcode << " is wider than the atlas." << std::endl;
+            continue;
         }
 
-        vsg::vec4 uvrect(
-            (float(xpos - quad_margin) - 1.0f) / float(atlas->width() - 1), float(ypos + height + quad_margin) / float(atlas->height() - 1),
-            float(xpos + width + quad_margin) / float(atlas->width() - 1), float((ypos - quad_margin) - 1.0f) / float(atlas->height() - 1));
+        required_height = std::max(required_height, packer->extentY());
 
-        vsg::GlyphMetrics vsg_metrics;
-        vsg_metrics.uvrect = uvrect;
-        vsg_metrics.width = float(width + 2 * quad_margin) / float(pixel_size);
-        vsg_metrics.height = float(height + 2 * quad_margin) / float(pixel_size);
-        vsg_metrics.horiBearingX = (float(metrics.horiBearingX) * freetype_pixel_size_scale - float(quad_margin)) / float(pixel_size);
-        vsg_metrics.horiBearingY = (float(metrics.horiBearingY) * freetype_pixel_size_scale + float(quad_margin)) / float(pixel_size);
-        vsg_metrics.horiAdvance = (float(metrics.horiAdvance) * freetype_pixel_size_scale) / float(pixel_size);
-        vsg_metrics.vertBearingX = (float(metrics.vertBearingX) * freetype_pixel_size_scale - float(quad_margin)) / float(pixel_size);
-        vsg_metrics.vertBearingY = (float(metrics.vertBearingY) * freetype_pixel_size_scale + float(quad_margin)) / float(pixel_size);
-        vsg_metrics.vertAdvance = (float(metrics.vertAdvance) * freetype_pixel_size_scale) / float(pixel_size);
+        if (charcode > max_charcode) max_charcode = charcode;
 
-        // assign the glyph metrics and charcode/glyph_index to the VSG glyphMetrics and charmap containers.
-        glyphMetrics->set(destation_glyphindex, vsg_metrics);
-        charmap->set(glyphQuad.charcode, destation_glyphindex);
+        newGlyphs.push_back(std::move(glyph));
+    }
 
-        ++destation_glyphindex;
+    if (newGlyphs.empty()) return 0;
+
+    if (required_height > atlas->height())
+    {
+        // grow the atlas by at least doubling its height so repeated additions don't reallocate each time, existing rows are retained as is.
+        auto previous_atlas = atlas;
+        atlas = freetype::Implementation::createAtlas(settings, previous_atlas->width(), std::max(required_height, previous_atlas->height() * 2));
+        std::memcpy(atlas->dataPointer(), previous_atlas->dataPointer(), previous_atlas->dataSize());
+        font.atlas = atlas;
+
+        reallocated = true;
+        dirtyRegions.clear();
+    }
 
-        unsigned int local_ytop = ypos + height + texel_margin;
-        if (local_ytop > ytop) ytop = local_ytop;
+    // the glyph count of the GlyphMetricsArray is fixed so copy the existing entries across to a larger one.
+    auto previous_glyphMetrics = font.glyphMetrics;
+    auto glyphMetrics = vsg::GlyphMetricsArray::create(static_cast<uint32_t>(previous_glyphMetrics->size() + newGlyphs.size()));
+    std::copy(previous_glyphMetrics->begin(), previous_glyphMetrics->end(), glyphMetrics->begin());
 
-        xpos += (width + texel_margin);
-        if (xpos > xtop) xtop = xpos;
+    // uvrects are relative to the atlas dimensions so need updating if the atlas has been reallocated.
+    if (reallocated)
+    {
+        for (size_t i = 1; i < glyphRegions.size(); ++i)
+        {
+            auto& r = glyphRegions[i];
+            glyphMetrics->at(i).uvrect = freetype::Implementation::uvrect(*atlas, settings, r.x, r.y, r.width, r.height);
+        }
     }
 
-    font->ascender = float(face->ascender) * freetype_pixel_size_scale / float(pixel_size);
-    font->descender = float(face->descender) * freetype_pixel_size_scale / float(pixel_size);
-    font->height = float(face->height) * freetype_pixel_size_scale / float(pixel_size);
-    font->glyphMetrics = glyphMetrics;
-    font->charmap = charmap;
+    auto charmap = font.charmap;
+    if (max_charcode >= charmap->size())
+    {
+        charmap = vsg::uintArray::create(max_charcode + 1);
+        for (auto& c : *charmap) c = 0;
+        std::copy(font.charmap->begin(), font.charmap->end(), charmap->begin());
+    }
 
-    font->options = const_cast<vsg::Options*>(options.get());
+    uint32_t glyph_index = static_cast<uint32_t>(previous_glyphMetrics->size());
+    for (auto& glyph : newGlyphs)
+    {
+        auto& region = glyph.region;
+        auto before_compute = stats ? clock::now() : clock::time_point();
+        size_t numTexels = generator.computeAtlasRegion(*atlas, settings, region);
+        if (stats)
+        {
+            stats->numTexels += numTexels;
+            stats->distanceTime += std::chrono::duration<double>(clock::now() - before_compute).count();
+        }
 
-    return font;
+        glyph.metrics.uvrect = freetype::Implementation::uvrect(*atlas, settings, region.xpos, region.ypos, region.width, region.height);
+        glyphMetrics->set(glyph_index, glyph.metrics);
+        charmap->set(glyph.charcode, glyph_index);
+        ++glyph_index;
+
+        glyphRegions.push_back(Region{region.xpos, region.ypos, region.width, region.height});
+        if (!reallocated) dirtyRegions.push_back(Region{region.xpos - delta, region.ypos - delta, region.width + 2 * delta, region.height + 2 * delta});
+    }
+
+    font.glyphMetrics = glyphMetrics;
+    font.charmap = charmap;
+
+    atlas->dirty();
+
+    if (stats)
+    {
+        stats->numGlyphs += static_cast<uint32_t>(newGlyphs.size());
+        stats->packingEfficiency = double(packer->usedArea()) / (double(atlas->width()) * double(atlas->height()));
+        stats->totalTime += std::chrono::duration<double>(clock::now() - start_time).count();
+    }
+
+    return static_cast<uint32_t>(newGlyphs.size());
 }
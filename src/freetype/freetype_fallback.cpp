@@ -36,3 +36,39 @@ bool freetype::getFeatures(Features&) const
 {
     return false;
 }
+bool freetype::readOptions(vsg::Options&, vsg::CommandLine&) const
+{
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DynamicFont fallback
+//
+struct DynamicFont::Implementation
+{
+};
+DynamicFont::DynamicFont() :
+    _implementation(nullptr)
+{
+}
+DynamicFont::~DynamicFont()
+{
+}
+uint32_t DynamicFont::addGlyphs(const std::vector<uint32_t>&)
+{
+    return 0;
+}
+uint32_t DynamicFont::addGlyphs(const std::wstring&)
+{
+    return 0;
+}
+bool DynamicFont::hasGlyph(uint32_t) const
+{
+    return false;
+}
+std::vector<DynamicFont::Region> DynamicFont::takeDirtyRegions(bool& reallocated)
+{
+    reallocated = false;
+    return {};
+}
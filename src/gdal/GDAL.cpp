@@ -15,8 +15,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsgGIS/gdal_utils.h>
 #include <vsgGIS/TileDatabase.h>
 
+#include "../utils/Mipmaps.h"
+
 #include <cstring>
 #include <iostream>
+#include <map>
 
 using namespace vsgXchange;
 
@@ -30,7 +33,13 @@ namespace vsgXchange
 
         vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options = {}) const;
 
+        /// return true if the file should be read by GDAL rather than left to the other ReaderWriters.
+        bool shouldRead(const vsg::Path& filename, const vsg::Path& ext) const;
+
     protected:
+        /// formats that vsgXchange reads natively or with the lightweight stbi/dds/ktx decoders, mapped to the world file extensions
+        /// that accompany georeferenced versions of them. These are only routed to GDAL when a georeferencing side car file is present.
+        std::map<vsg::Path, std::vector<vsg::Path>> _nonGeospatialFormats;
     };
 
 } // namespace vsgXchange
@@ -99,6 +108,12 @@ bool GDAL::getFeatures(Features& features) const
         }
     }
 
+    features.optionNameTypeMap[images::probe] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::generate_mipmaps] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_filter] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[images::mipmap_srgb] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_threads] = vsg::type_name<uint32_t>();
+
     return true;
 }
 
@@ -106,19 +121,62 @@ bool GDAL::getFeatures(Features& features) const
 //
 // GDAL ReaderWriter implementation
 //
-GDAL::Implementation::Implementation()
+GDAL::Implementation::Implementation() :
+    _nonGeospatialFormats{
+        {".vsgb", {}},
+        {".vsgt", {}},
+        {".osgb", {}},
+        {".osgt", {}},
+        {".osg", {}},
+        {".png", {".pgw", ".pngw"}},
+        {".jpg", {".jgw", ".jpgw"}},
+        {".jpeg", {".jgw", ".jpegw"}},
+        {".jpe", {".jgw"}},
+        {".gif", {".gfw", ".gifw"}},
+        {".bmp", {".bpw", ".bmpw"}},
+        {".tga", {}},
+        {".psd", {}},
+        {".pgm", {}},
+        {".ppm", {}},
+        {".hdr", {}},
+        {".dds", {}},
+        {".ktx", {}},
+        {".ktx2", {}}}
+{
+}
+
+bool GDAL::Implementation::shouldRead(const vsg::Path& filename, const vsg::Path& ext) const
 {
+    auto itr = _nonGeospatialFormats.find(ext);
+    if (itr == _nonGeospatialFormats.end()) return true;
+
+    // plain textures are only worth opening with GDAL when they have georeferencing to go with them.
+    auto& worldFileExtensions = itr->second;
+    if (worldFileExtensions.empty()) return false;
+
+    if (vsg::fileExists(filename + ".aux.xml")) return true;
+
+    auto basename = vsg::removeExtension(filename);
+    if (vsg::fileExists(basename + ".wld")) return true;
+    for (auto& worldFileExtension : worldFileExtensions)
+    {
+        if (vsg::fileExists(basename + worldFileExtension)) return true;
+    }
+    return false;
 }
 
 vsg::ref_ptr<vsg::Object> GDAL::Implementation::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
 {
-    // GDAL tries to load all datatypes so up front catch VSG and OSG native formats.
+    // GDAL tries to load all datatypes so up front catch VSG and OSG native formats, and plain textures that don't need GDAL.
     vsg::Path ext = vsg::lowerCaseFileExtension(filename);
-    if (ext == ".vsgb" || ext == ".vsgt" || ext == ".osgb" || ext == ".osgt" || ext == ".osg") return {};
+    auto itr = _nonGeospatialFormats.find(ext);
+    if (itr != _nonGeospatialFormats.end() && itr->second.empty()) return {};
 
     vsg::Path filenameToUse = vsg::findFile(filename, options);
     if (filenameToUse.empty()) return {};
 
+    if (!shouldRead(filenameToUse, ext)) return {};
+
     vsgGIS::initGDAL();
 
     auto dataset = vsgGIS::openSharedDataSet(filenameToUse.c_str(), GA_ReadOnly);
@@ -186,6 +244,19 @@ vsg::ref_ptr<vsg::Object> GDAL::Implementation::read(const vsg::Path& filename,
     int width = dataset->GetRasterXSize();
     int height = dataset->GetRasterYSize();
 
+    if (vsg::value<bool>(false, images::probe, options))
+    {
+        // take the layout from a single texel image so it matches what a full read would create.
+        auto texel = vsgGIS::createImage2D(1, 1, numComponents, dataType, vsg::dvec4(0.0, 0.0, 0.0, 1.0));
+        if (!texel) return {};
+
+        auto info = ImageInfo::create();
+        info->layout = texel->getLayout();
+        info->width = static_cast<uint32_t>(width);
+        info->height = static_cast<uint32_t>(height);
+        return info;
+    }
+
     auto image = vsgGIS::createImage2D(width, height, numComponents, dataType, vsg::dvec4(0.0, 0.0, 0.0, 1.0));
     if (!image) return {};
 
@@ -194,6 +265,8 @@ vsg::ref_ptr<vsg::Object> GDAL::Implementation::read(const vsg::Path& filename,
         vsgGIS::copyRasterBandToImage(*rasterBands[component], *image, component);
     }
 
+    image = generateMipmaps(image, options.get());
+
     vsgGIS::assignMetaData(*dataset, *image);
 
     if (dataset->GetProjectionRef() && std::strlen(dataset->GetProjectionRef()) > 0)
@@ -12,6 +12,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include <vsgXchange/images.h>
 
+#include "../utils/Signature.h"
+
 using namespace vsgXchange;
 
 images::images()
@@ -24,3 +26,13 @@ images::images()
     add(dds::create());
     add(ktx::create());
 }
+
+vsg::ref_ptr<vsg::Object> images::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
+{
+    return CompositeReaderWriter::read(fin, optionsWithSignatureHint(fin, options));
+}
+
+vsg::ref_ptr<vsg::Object> images::read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options) const
+{
+    return CompositeReaderWriter::read(ptr, size, optionsWithSignatureHint(ptr, size, options));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Data.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vsgXchange
+{
+
+    /// GPU format that Basis Universal ETC1S and UASTC textures are transcoded to.
+    struct TranscodeFormat
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint8_t blockWidth = 1;
+        uint8_t blockHeight = 1;
+        uint32_t blockSize = 4; /// bytes per block, or per texel for uncompressed formats
+    };
+
+    /// map a ktx::transcode_format name to the corresponding TranscodeFormat, returns false if the name isn't recognized.
+    inline bool transcodeFormat(const std::string& name, bool srgb, TranscodeFormat& transcode)
+    {
+        if (name == "bc7")
+            transcode = TranscodeFormat{srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK, 4, 4, 16};
+        else if (name == "bc3")
+            transcode = TranscodeFormat{srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK, 4, 4, 16};
+        else if (name == "bc1")
+            transcode = TranscodeFormat{srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK, 4, 4, 8};
+        else if (name == "astc")
+            transcode = TranscodeFormat{srgb ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK, 4, 4, 16};
+        else if (name == "rgba8")
+            transcode = TranscodeFormat{srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM, 1, 1, 4};
+        else
+            return false;
+        return true;
+    }
+
+    /// destination of a mipmap level in the buffer transcoded into, the layers and faces of the level follow each other from offset.
+    struct TranscodeLevel
+    {
+        size_t offset = 0;
+        uint32_t width = 0;  /// width in blocks, or texels for uncompressed formats
+        uint32_t height = 0; /// height in blocks, or texels for uncompressed formats
+        uint32_t level = 0;  /// index of the level in the KTX2 file
+    };
+
+    /// transcode the levels, layers and faces of the KTX2 file in data to transcode.format using the Basis Universal transcoder,
+    /// spreading the images across up to maxThreads threads. Images whose size differs from the TranscodeLevel are cropped or zero padded to fit.
+    /// Returns false if vsgXchange was built without vsgXchange_basisu or transcoding fails.
+    bool transcodeKtx2(const uint8_t* data, size_t size, const TranscodeFormat& transcode, const std::vector<TranscodeLevel>& levels, uint32_t numLayers, uint32_t numFaces, uint32_t maxThreads, uint8_t* buffer);
+
+} // namespace vsgXchange
@@ -0,0 +1,114 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Transcoder.h"
+#include "../utils/Parallel.h"
+
+#include <basisu_transcoder.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+using namespace vsgXchange;
+
+namespace
+{
+    bool basisFormat(VkFormat format, basist::transcoder_texture_format& basis_format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK: basis_format = basist::transcoder_texture_format::cTFBC7_RGBA; return true;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK: basis_format = basist::transcoder_texture_format::cTFBC3_RGBA; return true;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK: basis_format = basist::transcoder_texture_format::cTFBC1_RGB; return true;
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK: basis_format = basist::transcoder_texture_format::cTFASTC_4x4_RGBA; return true;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB: basis_format = basist::transcoder_texture_format::cTFRGBA32; return true;
+        default: return false;
+        }
+    }
+
+    std::once_flag s_transcoderInitialized;
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Basis Universal transcoding
+//
+bool vsgXchange::transcodeKtx2(const uint8_t* data, size_t size, const TranscodeFormat& transcode, const std::vector<TranscodeLevel>& levels, uint32_t numLayers, uint32_t numFaces, uint32_t maxThreads, uint8_t* buffer)
+{
+    basist::transcoder_texture_format basis_format;
+    if (!basisFormat(transcode.format, basis_format)) return false;
+
+    std::call_once(s_transcoderInitialized, []() { basist::basisu_transcoder_init(); });
+
+    // decoding of the ETC1S global codebooks is done once by start_transcoding(), after which each image can be transcoded independently,
+    // each with its own ktx2_transcoder_state.
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(data, static_cast<uint32_t>(size)) || !transcoder.start_transcoding()) return false;
+
+    const uint32_t numImages = numLayers * numFaces;
+    const uint32_t numTasks = static_cast<uint32_t>(levels.size()) * numImages;
+    std::atomic<bool> success{true};
+
+    parallelFor(numTasks, maxThreads, [&](uint32_t task) {
+        const auto& level = levels[task / numImages];
+        const uint32_t levelIndex = level.level;
+        const uint32_t image = task % numImages;
+        const uint32_t layerIndex = image / numFaces;
+        const uint32_t faceIndex = image % numFaces;
+        const size_t rowSize = static_cast<size_t>(level.width) * transcode.blockSize;
+        const size_t faceSize = rowSize * level.height;
+        uint8_t* dest = buffer + level.offset + image * faceSize;
+
+        basist::ktx2_image_level_info info;
+        if (!transcoder.get_image_level_info(info, levelIndex, layerIndex, faceIndex))
+        {
+            success = false;
+            return;
+        }
+
+        // block formats are sized in blocks, uncompressed formats in texels
+        const bool compressed = transcode.blockWidth > 1;
+        const uint32_t width = compressed ? info.m_num_blocks_x : info.m_orig_width;
+        const uint32_t height = compressed ? info.m_num_blocks_y : info.m_orig_height;
+
+        basist::ktx2_transcoder_state state;
+        if (width == level.width && height == level.height)
+        {
+            if (!transcoder.transcode_image_level(levelIndex, layerIndex, faceIndex, dest, width * height, basis_format, 0, 0, 0, -1, -1, &state)) success = false;
+            return;
+        }
+
+        // non power of two textures can have mipmaps a block larger or smaller than VSG's halving of the base level's blocks, so crop or pad them.
+        std::vector<uint8_t> scratch(static_cast<size_t>(width) * height * transcode.blockSize);
+        if (!transcoder.transcode_image_level(levelIndex, layerIndex, faceIndex, scratch.data(), width * height, basis_format, 0, 0, 0, -1, -1, &state))
+        {
+            success = false;
+            return;
+        }
+
+        std::memset(dest, 0, faceSize);
+        const size_t scratchRowSize = static_cast<size_t>(width) * transcode.blockSize;
+        for (uint32_t row = 0; row < std::min(height, level.height); ++row)
+        {
+            std::memcpy(dest + row * rowSize, scratch.data() + row * scratchRowSize, std::min(rowSize, scratchRowSize));
+        }
+    });
+
+    return success;
+}
@@ -46,5 +46,26 @@ set(KTX_SOURCES
     ktx/libktx/zstddeclib.c
 )
 source_group(libktx FILES ${KTX_SOURCES})
-set(SOURCES ${SOURCES} ${KTX_SOURCES} ktx/ktx.cpp)
+set(SOURCES ${SOURCES} ${KTX_SOURCES} ktx/ktx.cpp ktx/Transcoder.h)
 set(EXTRA_DEFINES ${EXTRA_DEFINES} KHRONOS_STATIC LIBKTX BASISD_SUPPORT_FXT1=0 BASISU_NO_ITERATOR_DEBUG_LEVEL KTX_FEATURE_KTX1 KTX_FEATURE_KTX2)
+
+# add the Basis Universal transcoder if a basis_universal source tree is provided, used to transcode ETC1S and UASTC KTX2 textures.
+# The transcoder's zstd dependency is provided by libktx's zstddeclib.c.
+set(BASISU_SOURCE_DIR "" CACHE PATH "Path to basis_universal source tree, used to build the Basis Universal transcoder")
+
+if(EXISTS "${BASISU_SOURCE_DIR}/transcoder/basisu_transcoder.cpp")
+    OPTION(vsgXchange_basisu "Optional Basis Universal KTX2 transcoding provided" ON)
+endif()
+
+if(${vsgXchange_basisu})
+    set(SOURCES ${SOURCES}
+        ${BASISU_SOURCE_DIR}/transcoder/basisu_transcoder.cpp
+        ktx/basisu.cpp
+    )
+    set(EXTRA_INCLUDES ${EXTRA_INCLUDES} ${BASISU_SOURCE_DIR}/transcoder)
+    set(EXTRA_DEFINES ${EXTRA_DEFINES} BASISD_SUPPORT_KTX2=1 BASISD_SUPPORT_KTX2_ZSTD=1)
+else()
+    set(SOURCES ${SOURCES}
+        ktx/basisu_fallback.cpp
+    )
+endif()
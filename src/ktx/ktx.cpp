@@ -15,14 +15,25 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/core/Exception.h>
 #include <vsg/state/DescriptorImage.h>
 
+#include "../utils/InputBuffer.h"
+#include "../utils/MappedFile.h"
+#include "../utils/Parallel.h"
+#include "Transcoder.h"
+
+#include <KHR/khr_df.h>
 #include <ktx.h>
+#include <ktxint.h>
 #include <ktxvulkan.h>
 #include <texture.h>
+#include <texture2.h>
 #include <vk_format.h>
+#include <zstd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 namespace
 {
@@ -39,14 +50,279 @@ namespace
         }
     }
 
-    vsg::ref_ptr<vsg::Data> readKtx(ktxTexture* texture, const vsg::Path& /*filename*/)
+    /// select the format a Basis Universal ETC1S or UASTC texture is transcoded to, returns false if the texture doesn't need transcoding.
+    bool transcodeTarget(ktxTexture* texture, const vsg::Options* options, vsgXchange::TranscodeFormat& transcode)
+    {
+        if (texture->classId != ktxTexture2_c) return false;
+
+        auto texture2 = reinterpret_cast<ktxTexture2*>(texture);
+        if (!ktxTexture2_NeedsTranscoding(texture2)) return false;
+
+        std::string name("bc7");
+        if (options) options->getValue(vsgXchange::ktx::transcode_format, name);
+
+        const bool srgb = ktxTexture2_GetOETF(texture2) == KHR_DF_TRANSFER_SRGB;
+        if (!vsgXchange::transcodeFormat(name, srgb, transcode)) throw vsg::Exception{"Unsupported transcode_format : " + name};
+
+        return true;
+    }
+
+    vsg::Data::Layout computeLayout(ktxTexture* texture, const vsgXchange::TranscodeFormat* transcode = nullptr)
+    {
+        vsg::Data::Layout layout;
+        if (transcode)
+        {
+            layout.format = transcode->format;
+            layout.blockWidth = transcode->blockWidth;
+            layout.blockHeight = transcode->blockHeight;
+            layout.blockDepth = 1;
+        }
+        else
+        {
+            layout.format = ktxTexture_GetVkFormat(texture);
+            layout.blockWidth = texture->_protected->_formatSize.blockWidth;
+            layout.blockHeight = texture->_protected->_formatSize.blockHeight;
+            layout.blockDepth = texture->_protected->_formatSize.blockDepth;
+        }
+        layout.maxNumMipmaps = texture->numLevels;
+        layout.origin = static_cast<uint8_t>(((texture->orientation.x == KTX_ORIENT_X_RIGHT) ? 0 : 1) |
+                                             ((texture->orientation.y == KTX_ORIENT_Y_DOWN) ? 0 : 2) |
+                                             ((texture->orientation.z == KTX_ORIENT_Z_OUT) ? 0 : 4));
+
+        const auto numLayers = texture->numLayers;
+        switch (texture->numDimensions)
+        {
+        case 1:
+            layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_1D : VK_IMAGE_VIEW_TYPE_1D_ARRAY;
+            break;
+        case 2:
+            if (texture->isCubemap)
+                layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_CUBE_ARRAY;
+            else
+                layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+            break;
+        case 3:
+            layout.imageViewType = VK_IMAGE_VIEW_TYPE_3D;
+            break;
+        default:
+            throw vsg::Exception{"Invalid number of dimensions."};
+        }
+
+        return layout;
+    }
+
+    /// number of dimensions of the vsg::Array holding the texture, setting height or depth to the number of layers and cube map faces when they add a dimension.
+    uint32_t arrayDimensions(ktxTexture* texture, uint32_t& height, uint32_t& depth)
+    {
+        const auto numLayers = texture->numLayers;
+        switch (texture->numDimensions)
+        {
+        case 1:
+            height = numLayers;
+            return (numLayers == 1) ? 1 : 2;
+
+        case 2:
+            if (texture->isCubemap)
+            {
+                depth = 6 * numLayers;
+                return 3;
+            }
+            depth = numLayers;
+            return (numLayers == 1) ? 2 : 3;
+
+        case 3:
+            return 3;
+        }
+        return 0;
+    }
+
+    /// number of the largest mipmap levels to leave out of the vsg::Data, from images::skip_mip_levels, always keeping the smallest level.
+    uint32_t firstMipLevel(ktxTexture* texture, const vsg::Options* options)
     {
+        uint32_t skip = 0;
+        if (options) options->getValue(vsgXchange::images::skip_mip_levels, skip);
+        return std::min(skip, texture->numLevels - 1);
+    }
+
+    /// create an ImageInfo from a texture created without KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, destroying the texture.
+    vsg::ref_ptr<vsgXchange::ImageInfo> probeKtx(ktxTexture* texture, const vsg::Options* options)
+    {
+        auto info = vsgXchange::ImageInfo::create();
+        try
+        {
+            const auto firstLevel = firstMipLevel(texture, options);
+
+            vsgXchange::TranscodeFormat transcode;
+            info->layout = computeLayout(texture, transcodeTarget(texture, options, transcode) ? &transcode : nullptr);
+            info->layout.maxNumMipmaps = static_cast<uint8_t>(texture->numLevels - firstLevel);
+            info->width = std::max(texture->baseWidth >> firstLevel, 1u);
+            info->height = std::max(texture->baseHeight >> firstLevel, 1u);
+            info->depth = std::max(texture->baseDepth >> firstLevel, 1u);
+            info->layers = texture->numLayers * texture->numFaces;
+            info->mipLevels = texture->numLevels - firstLevel;
+        }
+        catch (const vsg::Exception& ve)
+        {
+            std::cout << "ktx::probe() failed : " << ve.message << std::endl;
+            info = {};
+        }
+
+        ktxTexture_Destroy(texture);
+
+        return info;
+    }
+
+    /// destination in the vsg::Data buffer of the image data loaded by ktxTexture_IterateLoadLevelFaces() or loadLevels(),
+    /// levelOffsets and faceSizes are indexed by level relative to firstLevel, the first level of the file held by the vsg::Data.
+    struct LoadTarget
+    {
+        uint8_t* data = nullptr;
+        uint32_t numImages = 1;
+        uint32_t firstLevel = 0;
+        bool facesPassedSeparately = false;
+        std::vector<size_t> levelOffsets;
+        std::vector<size_t> faceSizes;
+    };
+
+    /// copy numImages images packed one after another in src to dest, cropping or padding them to faceSize.
+    void copyImages(uint8_t* dest, size_t faceSize, const uint8_t* src, size_t srcSize, uint32_t numImages)
+    {
+        const size_t ktxImageSize = srcSize / numImages;
+        for (uint32_t i = 0; i < numImages; ++i)
+        {
+            std::memcpy(dest + i * faceSize, src + i * ktxImageSize, std::min(faceSize, ktxImageSize));
+        }
+    }
+
+    KTX_error_code copyLevelFaces(int miplevel, int face, int /*width*/, int /*height*/, int /*depth*/, ktx_uint64_t faceLodSize, void* pixels, void* userdata)
+    {
+        auto& target = *static_cast<LoadTarget*>(userdata);
+        if (static_cast<uint32_t>(miplevel) < target.firstLevel) return KTX_SUCCESS;
+
+        // libktx passes the faces of non array cube maps one at a time, otherwise all the layers and faces of a level together.
+        const uint32_t level = miplevel - target.firstLevel;
+        const size_t faceSize = target.faceSizes[level];
+        uint8_t* dest = target.data + target.levelOffsets[level] + (target.facesPassedSeparately ? face * faceSize : 0);
+        copyImages(dest, faceSize, static_cast<const uint8_t*>(pixels), static_cast<size_t>(faceLodSize), target.facesPassedSeparately ? 1 : target.numImages);
+
+        return KTX_SUCCESS;
+    }
+
+    /// load the levels of an uncompressed or zstd supercompressed KTX2 texture from the file data straight into their place in the vsg::Data buffer,
+    /// the levels before target.firstLevel are never touched so only the pages of the levels required are read from a mapped file.
+    /// Each zstd supercompressed level is a separate zstd frame, so they are inflated in parallel, largest first.
+    bool loadLevels(ktxTexture2* texture, const uint8_t* fileData, size_t fileSize, const LoadTarget& target, uint32_t maxThreads)
+    {
+        const ktxLevelIndexEntry* levelIndex = texture->_private->_levelIndex;
+        const size_t firstLevelFileOffset = texture->_private->_firstLevelFileOffset;
+        const bool zstd = texture->supercompressionScheme == KTX_SS_ZSTD;
+
+        std::atomic<bool> success{true};
+        vsgXchange::parallelFor(texture->numLevels - target.firstLevel, zstd ? maxThreads : 1, [&](uint32_t level) {
+            const auto& entry = levelIndex[target.firstLevel + level];
+            const size_t offset = firstLevelFileOffset + entry.byteOffset;
+            if (offset > fileSize || entry.byteLength > fileSize - offset)
+            {
+                success = false;
+                return;
+            }
+
+            const auto src = fileData + offset;
+            const size_t faceSize = target.faceSizes[level];
+            const size_t levelSize = faceSize * target.numImages;
+            uint8_t* dest = target.data + target.levelOffsets[level];
+
+            if (!zstd)
+            {
+                copyImages(dest, faceSize, src, entry.byteLength, target.numImages);
+                return;
+            }
+
+            if (entry.uncompressedByteLength == levelSize)
+            {
+                if (ZSTD_decompress(dest, levelSize, src, entry.byteLength) != levelSize) success = false;
+                return;
+            }
+
+            // the level's images differ in size from VSG's, so inflate into a scratch buffer and copy each image into place.
+            std::vector<uint8_t> scratch(entry.uncompressedByteLength);
+            if (ZSTD_decompress(scratch.data(), scratch.size(), src, entry.byteLength) != scratch.size())
+            {
+                success = false;
+                return;
+            }
+
+            copyImages(dest, faceSize, scratch.data(), scratch.size(), target.numImages);
+        });
+
+        return success;
+    }
+
+    /// create a vsg::Data from a Basis Universal ETC1S or UASTC texture, transcoding the KTX2 file in fileData into its buffer.
+    vsg::ref_ptr<vsg::Data> transcodeKtx(ktxTexture* texture, const vsgXchange::TranscodeFormat& transcode, const uint8_t* fileData, size_t fileSize, const vsg::Options* options)
+    {
+        if (!fileData) throw vsg::Exception{"Unable to transcode, file could not be mapped into memory."};
+
+        const auto firstLevel = firstMipLevel(texture, options);
+
+        auto layout = computeLayout(texture, &transcode);
+        layout.maxNumMipmaps = static_cast<uint8_t>(texture->numLevels - firstLevel);
+
+        uint32_t width = (std::max(texture->baseWidth >> firstLevel, 1u) + transcode.blockWidth - 1) / transcode.blockWidth;
+        uint32_t height = (std::max(texture->baseHeight >> firstLevel, 1u) + transcode.blockHeight - 1) / transcode.blockHeight;
+        uint32_t depth = texture->baseDepth;
+
+        // the layers and faces of each mipmap level follow each other, with the level sizes halved in blocks as VSG assumes.
+        const uint32_t numImages = texture->numLayers * texture->numFaces;
+        std::vector<vsgXchange::TranscodeLevel> levels;
+        size_t textureSize = 0;
+        {
+            auto mipWidth = width;
+            auto mipHeight = height;
+            for (uint32_t level = firstLevel; level < texture->numLevels; ++level)
+            {
+                levels.push_back(vsgXchange::TranscodeLevel{textureSize, mipWidth, mipHeight, level});
+                textureSize += static_cast<size_t>(mipWidth) * mipHeight * transcode.blockSize * numImages;
+
+                if (mipWidth > 1) mipWidth /= 2;
+                if (mipHeight > 1) mipHeight /= 2;
+            }
+        }
+
+        uint32_t maxThreads = 0;
+        if (options) options->getValue(vsgXchange::ktx::max_threads, maxThreads);
+
+        uint8_t* textureData = new uint8_t[textureSize];
+        if (!vsgXchange::transcodeKtx2(fileData, fileSize, transcode, levels, texture->numLayers, texture->numFaces, maxThreads, textureData))
+        {
+            delete[] textureData;
+#ifdef vsgXchange_basisu
+            throw vsg::Exception{"Unable to transcode image data."};
+#else
+            throw vsg::Exception{"Unable to transcode image data, vsgXchange built without vsgXchange_basisu."};
+#endif
+        }
+
+        const auto dimensions = arrayDimensions(texture, height, depth);
+        switch (transcode.blockSize)
+        {
+        case 8: return createImage<vsg::block64>(dimensions, width, height, depth, textureData, layout);
+        case 16: return createImage<vsg::block128>(dimensions, width, height, depth, textureData, layout);
+        default: return createImage<vsg::ubvec4>(dimensions, width, height, depth, textureData, layout);
+        }
+    }
+
+    /// create a vsg::Data from a texture created without KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, loading the image data into its buffer.
+    /// fileData is the KTX file the texture was created from, required for transcoding, or null if it isn't available.
+    vsg::ref_ptr<vsg::Data> readKtx(ktxTexture* texture, const vsg::Path& /*filename*/, const uint8_t* fileData, size_t fileSize, const vsg::Options* options)
+    {
+        vsgXchange::TranscodeFormat transcode;
+        if (transcodeTarget(texture, options, transcode)) return transcodeKtx(texture, transcode, fileData, fileSize, options);
+
         uint32_t width = texture->baseWidth;
         uint32_t height = texture->baseHeight;
         uint32_t depth = texture->baseDepth;
         const auto numMipMaps = texture->numLevels;
-        const auto numLayers = texture->numLayers;
-        const auto textureData = ktxTexture_GetData(texture);
         const auto format = ktxTexture_GetVkFormat(texture);
 
         ktxFormatSize formatSize;
@@ -68,21 +344,27 @@ namespace
 
         auto valueSize = ktxTexture_GetElementSize(texture);
 
-        vsg::Data::Layout layout;
-        layout.format = format;
-        layout.blockWidth = texture->_protected->_formatSize.blockWidth;
-        layout.blockHeight = texture->_protected->_formatSize.blockHeight;
-        layout.blockDepth = texture->_protected->_formatSize.blockDepth;
-        layout.maxNumMipmaps = numMipMaps;
-        layout.origin = static_cast<uint8_t>(((texture->orientation.x == KTX_ORIENT_X_RIGHT) ? 0 : 1) |
-                                             ((texture->orientation.y == KTX_ORIENT_Y_DOWN) ? 0 : 2) |
-                                             ((texture->orientation.z == KTX_ORIENT_Z_OUT) ? 0 : 4));
+        const auto firstLevel = firstMipLevel(texture, options);
+
+        auto layout = computeLayout(texture);
+        layout.maxNumMipmaps = static_cast<uint8_t>(numMipMaps - firstLevel);
 
         width /= layout.blockWidth;
         height /= layout.blockHeight;
         depth /= layout.blockDepth;
 
-        // compute the textureSize.
+        // compute the textureSize and the offset of each mipmap level in the order assumed by VSG,
+        // checking whether libktx's layout of the image data already matches it.
+        const uint32_t numImages = texture->numLayers * texture->numFaces;
+        const auto supercompressionScheme = texture->classId == ktxTexture2_c ? reinterpret_cast<ktxTexture2*>(texture)->supercompressionScheme : KTX_SS_NONE;
+        const bool supercompressed = supercompressionScheme != KTX_SS_NONE;
+        bool matchesLayout = (!supercompressed || numMipMaps == 1) && firstLevel == 0;
+
+        LoadTarget target;
+        target.numImages = numImages;
+        target.firstLevel = firstLevel;
+        target.facesPassedSeparately = texture->isCubemap && !texture->isArray;
+
         size_t textureSize = 0;
         {
             auto mipWidth = width;
@@ -91,85 +373,83 @@ namespace
 
             for (uint32_t level = 0; level < numMipMaps; ++level)
             {
+                // skipped levels only contribute to the halving of the dimensions
+                if (level < firstLevel)
+                {
+                    if (mipWidth > 1) mipWidth /= 2;
+                    if (mipHeight > 1) mipHeight /= 2;
+                    if (mipDepth > 1) mipDepth /= 2;
+                    if (level + 1 == firstLevel)
+                    {
+                        width = mipWidth;
+                        height = mipHeight;
+                        depth = mipDepth;
+                    }
+                    continue;
+                }
+
                 const auto faceSize = std::max(mipWidth * mipHeight * mipDepth * valueSize, valueSize);
-                textureSize += faceSize;
+                target.levelOffsets.push_back(textureSize);
+                target.faceSizes.push_back(faceSize);
+
+                if (ktxTexture_GetImageSize(texture, level) != faceSize) matchesLayout = false;
+
+                // the image offsets of supercompressed textures aren't known until the data is inflated, a single level is always contiguous
+                for (uint32_t image = 0; matchesLayout && !supercompressed && image < numImages; ++image)
+                {
+                    ktx_size_t ktxOffset = 0;
+                    if (ktxTexture_GetImageOffset(texture, level, image / texture->numFaces, image % texture->numFaces, &ktxOffset) != KTX_SUCCESS ||
+                        ktxOffset != textureSize + image * faceSize)
+                    {
+                        matchesLayout = false;
+                    }
+                }
+
+                textureSize += faceSize * numImages;
 
                 if (mipWidth > 1) mipWidth /= 2;
                 if (mipHeight > 1) mipHeight /= 2;
                 if (mipDepth > 1) mipDepth /= 2;
             }
-            textureSize *= (texture->numLayers * texture->numFaces);
         }
 
-        // copy the data and repack into ordered assumed by VSG
-        uint8_t* copiedData = new uint8_t[textureSize];
-
-        size_t offset = 0;
+        if (ktxTexture_GetDataSizeUncompressed(texture) != textureSize) matchesLayout = false;
 
-        auto mipWidth = width;
-        auto mipHeight = height;
-        auto mipDepth = depth;
+        // load the image data straight into the buffer passed to the vsg::Data rather than loading it into libktx's buffer and repacking a copy,
+        // when the layouts differ, i.e. KTX2 stores the smallest mipmap level first or levels are skipped, the levels are loaded one at a time and copied into place.
+        // When the file data is available the KTX2 levels are copied or inflated from it directly, zstd supercompressed levels in parallel,
+        // otherwise libktx reads the levels one after another, including any that are skipped.
+        uint8_t* textureData = new uint8_t[textureSize];
+        target.data = textureData;
 
-        for (uint32_t level = 0; level < numMipMaps; ++level)
+        KTX_error_code result = KTX_SUCCESS;
+        if (fileData && !matchesLayout && texture->classId == ktxTexture2_c && (supercompressionScheme == KTX_SS_NONE || supercompressionScheme == KTX_SS_ZSTD))
         {
-            const auto faceSize = std::max(mipWidth * mipHeight * mipDepth * valueSize, valueSize);
-            for (uint32_t layer = 0; layer < texture->numLayers; ++layer)
-            {
-                for (uint32_t face = 0; face < texture->numFaces; ++face)
-                {
-                    if (ktx_size_t ktxOffset = 0; ktxTexture_GetImageOffset(texture, level, layer, face, &ktxOffset) == KTX_SUCCESS)
-                    {
-                        std::memcpy(copiedData + offset, textureData + ktxOffset, faceSize);
-                    }
+            uint32_t maxThreads = 0;
+            if (options) options->getValue(vsgXchange::ktx::max_threads, maxThreads);
 
-                    offset += faceSize;
-                }
-            }
-            if (mipWidth > 1) mipWidth /= 2;
-            if (mipHeight > 1) mipHeight /= 2;
-            if (mipDepth > 1) mipDepth /= 2;
+            if (!loadLevels(reinterpret_cast<ktxTexture2*>(texture), fileData, fileSize, target, maxThreads)) result = KTX_FILE_DATA_ERROR;
         }
-
-        uint32_t arrayDimensions = 0;
-        switch (texture->numDimensions)
+        else
         {
-        case 1:
-            layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_1D : VK_IMAGE_VIEW_TYPE_1D_ARRAY;
-            arrayDimensions = (numLayers == 1) ? 1 : 2;
-            height = numLayers;
-            break;
-
-        case 2:
-            if (texture->isCubemap)
-            {
-                layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_CUBE : VK_IMAGE_VIEW_TYPE_CUBE_ARRAY;
-                arrayDimensions = 3;
-                depth = 6 * numLayers;
-            }
-            else
-            {
-                layout.imageViewType = (numLayers == 1) ? VK_IMAGE_VIEW_TYPE_2D : VK_IMAGE_VIEW_TYPE_2D_ARRAY;
-                arrayDimensions = (numLayers == 1) ? 2 : 3;
-                depth = numLayers;
-            }
-            break;
-
-        case 3:
-            layout.imageViewType = VK_IMAGE_VIEW_TYPE_3D;
-            arrayDimensions = 3;
-            break;
-
-        default:
-            throw vsg::Exception{"Invalid number of dimensions."};
+            result = matchesLayout ? ktxTexture_LoadImageData(texture, textureData, textureSize)
+                                   : ktxTexture_IterateLoadLevelFaces(texture, copyLevelFaces, &target);
+        }
+        if (result != KTX_SUCCESS)
+        {
+            delete[] textureData;
+            throw vsg::Exception{"Unable to load image data."};
         }
 
+        const auto dimensions = arrayDimensions(texture, height, depth);
+
         // create the VSG compressed image objects
         if (texture->isCompressed)
         {
             switch (valueSize)
             {
-            case 8: return createImage<vsg::block64>(arrayDimensions, width, height, depth, copiedData, layout);
-            case 16: return createImage<vsg::block128>(arrayDimensions, width, height, depth, copiedData, layout);
+            case 8: return createImage<vsg::block64>(dimensions, width, height, depth, textureData, layout);
+            case 16: return createImage<vsg::block128>(dimensions, width, height, depth, textureData, layout);
             default: throw vsg::Exception{"Unsupported compressed format."};
             }
         }
@@ -178,26 +458,26 @@ namespace
         switch (format)
         {
         case VK_FORMAT_R8_SRGB:
-        case VK_FORMAT_R8_UNORM: return createImage<uint8_t>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R8_SNORM: return createImage<int8_t>(arrayDimensions, width, height, depth, copiedData, layout);
+        case VK_FORMAT_R8_UNORM: return createImage<uint8_t>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R8_SNORM: return createImage<int8_t>(dimensions, width, height, depth, textureData, layout);
         case VK_FORMAT_R8G8_SRGB:
-        case VK_FORMAT_R8G8_UNORM: return createImage<vsg::ubvec2>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R8G8_SNORM: return createImage<vsg::bvec2>(arrayDimensions, width, height, depth, copiedData, layout);
+        case VK_FORMAT_R8G8_UNORM: return createImage<vsg::ubvec2>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R8G8_SNORM: return createImage<vsg::bvec2>(dimensions, width, height, depth, textureData, layout);
         case VK_FORMAT_R8G8B8_SRGB:
-        case VK_FORMAT_R8G8B8_UNORM: return createImage<vsg::ubvec3>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R8G8B8_SNORM: return createImage<vsg::bvec3>(arrayDimensions, width, height, depth, copiedData, layout);
+        case VK_FORMAT_R8G8B8_UNORM: return createImage<vsg::ubvec3>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R8G8B8_SNORM: return createImage<vsg::bvec3>(dimensions, width, height, depth, textureData, layout);
         case VK_FORMAT_R8G8B8A8_SRGB:
-        case VK_FORMAT_R8G8B8A8_UNORM: return createImage<vsg::ubvec4>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R8G8B8A8_SNORM: return createImage<vsg::bvec4>(arrayDimensions, width, height, depth, copiedData, layout);
-
-        case VK_FORMAT_R16_UNORM: return createImage<uint16_t>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16_SNORM: return createImage<int16_t>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16_UNORM: return createImage<vsg::usvec2>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16_SNORM: return createImage<vsg::svec2>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16B16_UNORM: return createImage<vsg::usvec3>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16B16_SNORM: return createImage<vsg::svec3>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16B16A16_UNORM: return createImage<vsg::usvec4>(arrayDimensions, width, height, depth, copiedData, layout);
-        case VK_FORMAT_R16G16B16A16_SNORM: return createImage<vsg::svec4>(arrayDimensions, width, height, depth, copiedData, layout);
+        case VK_FORMAT_R8G8B8A8_UNORM: return createImage<vsg::ubvec4>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R8G8B8A8_SNORM: return createImage<vsg::bvec4>(dimensions, width, height, depth, textureData, layout);
+
+        case VK_FORMAT_R16_UNORM: return createImage<uint16_t>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16_SNORM: return createImage<int16_t>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16_UNORM: return createImage<vsg::usvec2>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16_SNORM: return createImage<vsg::svec2>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16B16_UNORM: return createImage<vsg::usvec3>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16B16_SNORM: return createImage<vsg::svec3>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16B16A16_UNORM: return createImage<vsg::usvec4>(dimensions, width, height, depth, textureData, layout);
+        case VK_FORMAT_R16G16B16A16_SNORM: return createImage<vsg::svec4>(dimensions, width, height, depth, textureData, layout);
         default: break;
         }
 
@@ -206,22 +486,22 @@ namespace
         {
         case 1:
             // int8_t or uint8_t
-            return createImage<uint8_t>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<uint8_t>(dimensions, width, height, depth, textureData, layout);
         case 2:
             // short, ushort, ubvec2, bvec2
-            return createImage<uint16_t>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<uint16_t>(dimensions, width, height, depth, textureData, layout);
         case 3:
             // ubvec3 or bvec3
-            return createImage<vsg::ubvec3>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<vsg::ubvec3>(dimensions, width, height, depth, textureData, layout);
         case 4:
             // float, int, uint, usvec2, svec2, ubvec4, bvec4
-            return createImage<uint32_t>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<uint32_t>(dimensions, width, height, depth, textureData, layout);
         case 8:
             // double, vec2, ivec4, uivec4, svec4, uvec4
-            return createImage<vsg::usvec4>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<vsg::usvec4>(dimensions, width, height, depth, textureData, layout);
         case 16:
             // dvec2, vec4, ivec4, uivec4
-            return createImage<vsg::vec4>(arrayDimensions, width, height, depth, copiedData, layout);
+            return createImage<vsg::vec4>(dimensions, width, height, depth, textureData, layout);
         default:
             throw vsg::Exception{"Unsupported valueSize."};
         }
@@ -246,12 +526,25 @@ vsg::ref_ptr<vsg::Object> ktx::read(const vsg::Path& filename, vsg::ref_ptr<cons
     vsg::Path filenameToUse = findFile(filename, options);
     if (filenameToUse.empty()) return {};
 
-    if (ktxTexture * texture{nullptr}; ktxTexture_CreateFromNamedFile(filenameToUse.c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) == KTX_SUCCESS)
+    if (vsg::value<bool>(false, images::probe, options))
+    {
+        // without KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT only the headers are read from the file.
+        if (ktxTexture * texture{nullptr}; ktxTexture_CreateFromNamedFile(filenameToUse.c_str(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture) == KTX_SUCCESS) return probeKtx(texture, options.get());
+        return {};
+    }
+
+    // read the texture directly from a mapping of the file, falling back to libktx's own file reading.
+    // The image data is loaded by readKtx() into the vsg::Data buffer so libktx doesn't hold a second copy of it.
+    MappedFile mappedFile(filenameToUse);
+    ktxTexture* texture{nullptr};
+    KTX_error_code result = mappedFile.valid() ? ktxTexture_CreateFromMemory(mappedFile.data(), mappedFile.size(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture)
+                                               : ktxTexture_CreateFromNamedFile(filenameToUse.c_str(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture);
+    if (result == KTX_SUCCESS)
     {
         vsg::ref_ptr<vsg::Data> data;
         try
         {
-            data = readKtx(texture, filename);
+            data = readKtx(texture, filename, mappedFile.valid() ? mappedFile.data() : nullptr, mappedFile.size(), options.get());
         }
         catch (const vsg::Exception& ve)
         {
@@ -271,22 +564,20 @@ vsg::ref_ptr<vsg::Object> ktx::read(std::istream& fin, vsg::ref_ptr<const vsg::O
     if (!options || _supportedExtensions.count(options->extensionHint) == 0)
         return {};
 
-    std::string buffer(1 << 16, 0); // 64kB
-    std::string input;
+    InputBuffer input(fin);
 
-    while (!fin.eof())
+    if (vsg::value<bool>(false, images::probe, options))
     {
-        fin.read(&buffer[0], buffer.size());
-        const auto bytes_readed = fin.gcount();
-        input.append(&buffer[0], bytes_readed);
+        if (ktxTexture * texture{nullptr}; ktxTexture_CreateFromMemory((const ktx_uint8_t*)input.data(), input.size(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture) == KTX_SUCCESS) return probeKtx(texture, options.get());
+        return {};
     }
 
-    if (ktxTexture * texture{nullptr}; ktxTexture_CreateFromMemory((const ktx_uint8_t*)input.data(), input.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) == KTX_SUCCESS)
+    if (ktxTexture * texture{nullptr}; ktxTexture_CreateFromMemory((const ktx_uint8_t*)input.data(), input.size(), KTX_TEXTURE_CREATE_NO_FLAGS, &texture) == KTX_SUCCESS)
     {
         vsg::ref_ptr<vsg::Data> data;
         try
         {
-            data = readKtx(texture, "");
+            data = readKtx(texture, "", input.data(), input.size(), options.get());
         }
         catch (const vsg::Exception& ve)
         {
@@ -307,12 +598,18 @@ vsg::ref_ptr<vsg::Object> ktx::read(const uint8_t* ptr, size_t size, vsg::ref_pt
         return {};
 
     ktxTexture* texture = nullptr;
-    if (ktxTexture_CreateFromMemory(ptr, size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture) == KTX_SUCCESS)
+    if (vsg::value<bool>(false, images::probe, options))
+    {
+        if (ktxTexture_CreateFromMemory(ptr, size, KTX_TEXTURE_CREATE_NO_FLAGS, &texture) == KTX_SUCCESS) return probeKtx(texture, options.get());
+        return {};
+    }
+
+    if (ktxTexture_CreateFromMemory(ptr, size, KTX_TEXTURE_CREATE_NO_FLAGS, &texture) == KTX_SUCCESS)
     {
         vsg::ref_ptr<vsg::Data> data;
         try
         {
-            data = readKtx(texture, "");
+            data = readKtx(texture, "", ptr, size, options.get());
         }
         catch (const vsg::Exception& ve)
         {
@@ -333,5 +630,20 @@ bool ktx::getFeatures(Features& features) const
     {
         features.extensionFeatureMap[ext] = static_cast<vsg::ReaderWriter::FeatureMask>(vsg::ReaderWriter::READ_FILENAME | vsg::ReaderWriter::READ_ISTREAM | vsg::ReaderWriter::READ_MEMORY);
     }
+
+    features.optionNameTypeMap[images::probe] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::skip_mip_levels] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[ktx::transcode_format] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[ktx::max_threads] = vsg::type_name<uint32_t>();
+
     return true;
 }
+
+bool ktx::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
+{
+    bool result = arguments.readAndAssign<void>(images::probe, &options);
+    result = arguments.readAndAssign<uint32_t>(images::skip_mip_levels, &options) || result;
+    result = arguments.readAndAssign<std::string>(transcode_format, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(max_threads, &options) || result;
+    return result;
+}
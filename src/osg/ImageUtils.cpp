@@ -12,11 +12,15 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "ImageUtils.h"
 
+#include "../utils/PixelConversion.h"
+
 #include <vsg/vk/CommandBuffer.h>
 
 #include <vsg/core/Array2D.h>
 #include <vsg/core/Array3D.h>
 
+#include <functional>
+
 namespace osg2vsg
 {
 
@@ -54,6 +58,35 @@ namespace osg2vsg
 
         new_image->allocateImage(image->s(), image->t(), image->r(), targetPixelFormat, image->getDataType());
 
+        if (image->getDataType() == GL_UNSIGNED_BYTE)
+        {
+            // common 8 bit conversions are handled by the SIMD pixel conversions, row by row to respect the image packing.
+            std::function<void(const unsigned char*, unsigned char*, size_t)> convertRow;
+            GLenum sourcePixelFormat = image->getPixelFormat();
+            if (targetPixelFormat == GL_RGBA && (sourcePixelFormat == GL_RGB || sourcePixelFormat == GL_BGR))
+            {
+                bool isBGR = (sourcePixelFormat == GL_BGR);
+                convertRow = [isBGR](const unsigned char* src, unsigned char* dst, size_t numPixels) { vsgXchange::convertRGBtoRGBA(src, dst, numPixels, isBGR); };
+            }
+            else if ((targetPixelFormat == GL_RGB && sourcePixelFormat == GL_BGR) || (targetPixelFormat == GL_RGBA && sourcePixelFormat == GL_BGRA))
+            {
+                uint32_t numComponents = (targetPixelFormat == GL_RGB) ? 3 : 4;
+                convertRow = [numComponents](const unsigned char* src, unsigned char* dst, size_t numPixels) { vsgXchange::swapRedBlue(src, dst, numPixels, numComponents); };
+            }
+
+            if (convertRow)
+            {
+                for (int r = 0; r < image->r(); ++r)
+                {
+                    for (int t = 0; t < image->t(); ++t)
+                    {
+                        convertRow(image->data(0, t, r), new_image->data(0, t, r), image->s());
+                    }
+                }
+                return new_image;
+            }
+        }
+
         int numBytesPerComponent = 1;
         unsigned char component_default[8] = {255, 0, 0, 0, 0, 0, 0, 0};
         switch (image->getDataType())
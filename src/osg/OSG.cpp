@@ -10,6 +10,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 </editor-fold> */
 
+#include <vsgXchange/images.h>
 #include <vsgXchange/models.h>
 
 #include <osg/TransferFunction>
@@ -26,6 +27,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "Optimize.h"
 #include "SceneBuilder.h"
 
+#include "../utils/Mipmaps.h"
+
 #include <iostream>
 
 using namespace vsgXchange;
@@ -108,6 +111,10 @@ bool OSG::getFeatures(Features& features) const
     features.optionNameTypeMap[OSG::original_converter] = vsg::type_name<bool>();
     features.optionNameTypeMap[OSG::read_build_options] = vsg::type_name<std::string>();
     features.optionNameTypeMap[OSG::write_build_options] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[images::generate_mipmaps] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_filter] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[images::mipmap_srgb] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_threads] = vsg::type_name<uint32_t>();
 
     return true;
 }
@@ -126,6 +133,10 @@ bool OSG::Implementation::readOptions(vsg::Options& options, vsg::CommandLine& a
     bool result = arguments.readAndAssign<void>(OSG::original_converter, &options);
     result = arguments.readAndAssign<std::string>(OSG::read_build_options, &options) || result;
     result = arguments.readAndAssign<std::string>(OSG::write_build_options, &options) || result;
+    result = arguments.readAndAssign<void>(images::generate_mipmaps, &options) || result;
+    result = arguments.readAndAssign<std::string>(images::mipmap_filter, &options) || result;
+    result = arguments.readAndAssign<void>(images::mipmap_srgb, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(images::mipmap_threads, &options) || result;
     return result;
 }
 
@@ -254,7 +265,7 @@ vsg::ref_ptr<vsg::Object> OSG::Implementation::read(const vsg::Path& filename, v
     }
     else if (osg::Image* osg_image = dynamic_cast<osg::Image*>(object.get()); osg_image != nullptr)
     {
-        return osg2vsg::convertToVsg(osg_image, mapRGBtoRGBAHint);
+        return vsgXchange::generateMipmaps(osg2vsg::convertToVsg(osg_image, mapRGBtoRGBAHint), options.get());
     }
     else if (osg::TransferFunction1D* tf = dynamic_cast<osg::TransferFunction1D*>(object.get()); tf != nullptr)
     {
@@ -17,6 +17,8 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "Optimize.h"
 #include "ShaderUtils.h"
 
+#include "../utils/Mipmaps.h"
+
 #include <vsg/nodes/CullGroup.h>
 #include <vsg/nodes/CullNode.h>
 #include <vsg/nodes/MatrixTransform.h>
@@ -115,7 +117,7 @@ vsg::ref_ptr<vsg::DescriptorImage> SceneBuilderBase::convertToVsgTexture(const o
     if (auto itr = texturesMap.find(osgtexture); itr != texturesMap.end()) return itr->second;
 
     const osg::Image* image = osgtexture ? osgtexture->getImage(0) : nullptr;
-    auto textureData = convertToVsg(image, buildOptions->mapRGBtoRGBAHint);
+    auto textureData = vsgXchange::generateMipmaps(convertToVsg(image, buildOptions->mapRGBtoRGBAHint), buildOptions->options.get());
     if (!textureData)
     {
         // DEBUG_OUTPUT << "Could not convert osg image data" << std::endl;
@@ -0,0 +1,44 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Array2D.h>
+
+#include <cstdint>
+
+namespace vsgXchange
+{
+
+    /// decode JPEG data with libjpeg-turbo when vsgXchange is built with vsgXchange_jpegturbo.
+    /// Returns null if libjpeg-turbo isn't available or can't decode the data, so the caller can fall back to stb_image.
+    /// A non zero maxDimension scales the image by up to 1/8 during the inverse DCT, the caller box filters any further reduction required.
+    vsg::ref_ptr<vsg::Data> readJPEG(const uint8_t* data, size_t size, bool mapRGBtoRGBAHint, uint32_t maxDimension);
+
+    /// decode 8 bit PNG data with libspng when vsgXchange is built with vsgXchange_spng.
+    /// Returns null if libspng isn't available or the image is left to stb_image, i.e. 16 bit images.
+    vsg::ref_ptr<vsg::Data> readPNG(const uint8_t* data, size_t size, bool mapRGBtoRGBAHint);
+
+    /// wrap decoded 8 bit pixels in a vsg::Data with the same layout as stb_image decoded images, taking ownership of pixels.
+    inline vsg::ref_ptr<vsg::Data> createImage8(uint8_t* pixels, uint32_t width, uint32_t height, uint32_t components)
+    {
+        switch (components)
+        {
+        case 1: return vsg::ubyteArray2D::create(width, height, pixels, vsg::Data::Layout{VK_FORMAT_R8_UNORM});
+        case 2: return vsg::ubvec2Array2D::create(width, height, reinterpret_cast<vsg::ubvec2*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8_UNORM});
+        case 3: return vsg::ubvec3Array2D::create(width, height, reinterpret_cast<vsg::ubvec3*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8B8_UNORM});
+        case 4: return vsg::ubvec4Array2D::create(width, height, reinterpret_cast<vsg::ubvec4*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8B8A8_UNORM});
+        default: delete[] pixels; return {};
+        }
+    }
+
+} // namespace vsgXchange
@@ -0,0 +1,50 @@
+# add libjpeg-turbo if available, used in place of stb_image for decoding JPEG.
+# libjpeg-turbo is detected via the JCS_EXTENSIONS it adds to the libjpeg API.
+find_package(JPEG)
+
+if(JPEG_FOUND)
+    include(CheckSymbolExists)
+    set(CMAKE_REQUIRED_INCLUDES ${JPEG_INCLUDE_DIRS})
+    check_symbol_exists(JCS_EXTENSIONS "stdio.h;jpeglib.h" JPEG_HAS_JCS_EXTENSIONS)
+    unset(CMAKE_REQUIRED_INCLUDES)
+
+    if(JPEG_HAS_JCS_EXTENSIONS)
+        OPTION(vsgXchange_jpegturbo "Optional libjpeg-turbo JPEG decoding provided" ON)
+    endif()
+endif()
+
+if(${vsgXchange_jpegturbo})
+    set(SOURCES ${SOURCES}
+        stbi/jpegturbo.cpp
+    )
+    set(EXTRA_INCLUDES ${EXTRA_INCLUDES} ${JPEG_INCLUDE_DIRS})
+    set(EXTRA_LIBRARIES ${EXTRA_LIBRARIES} ${JPEG_LIBRARIES})
+    if(NOT BUILD_SHARED_LIBS)
+        set(FIND_DEPENDENCY ${FIND_DEPENDENCY} "find_dependency(JPEG)")
+    endif()
+else()
+    set(SOURCES ${SOURCES}
+        stbi/jpegturbo_fallback.cpp
+    )
+endif()
+
+# add libspng if available, used in place of stb_image for decoding 8 bit PNG.
+find_package(SPNG CONFIG QUIET)
+
+if(SPNG_FOUND)
+    OPTION(vsgXchange_spng "Optional libspng PNG decoding provided" ON)
+endif()
+
+if(${vsgXchange_spng})
+    set(SOURCES ${SOURCES}
+        stbi/spng.cpp
+    )
+    set(EXTRA_LIBRARIES ${EXTRA_LIBRARIES} spng::spng)
+    if(NOT BUILD_SHARED_LIBS)
+        set(FIND_DEPENDENCY ${FIND_DEPENDENCY} "find_dependency(SPNG CONFIG)")
+    endif()
+else()
+    set(SOURCES ${SOURCES}
+        stbi/spng_fallback.cpp
+    )
+endif()
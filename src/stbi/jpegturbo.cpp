@@ -0,0 +1,110 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "../utils/Downsample.h"
+#include "Decoders.h"
+
+#include <algorithm>
+#include <climits>
+#include <csetjmp>
+#include <cstdio>
+
+#include <jpeglib.h>
+
+using namespace vsgXchange;
+
+namespace
+{
+    // libjpeg reports fatal errors through error_exit, which must not return, so jump back to readJPEG() to clean up.
+    struct ErrorManager
+    {
+        jpeg_error_mgr pub;
+        std::jmp_buf setjmpBuffer;
+    };
+
+    void errorExit(j_common_ptr cinfo)
+    {
+        std::longjmp(reinterpret_cast<ErrorManager*>(cinfo->err)->setjmpBuffer, 1);
+    }
+
+    void outputMessage(j_common_ptr)
+    {
+        // warnings about corrupt data are left for stb_image to report if libjpeg-turbo fails
+    }
+} // namespace
+
+vsg::ref_ptr<vsg::Data> vsgXchange::readJPEG(const uint8_t* data, size_t size, bool mapRGBtoRGBAHint, uint32_t maxDimension)
+{
+    if (size < 3 || data[0] != 0xff || data[1] != 0xd8 || size > ULONG_MAX) return {};
+
+    jpeg_decompress_struct cinfo;
+    ErrorManager errorManager;
+    cinfo.err = jpeg_std_error(&errorManager.pub);
+    errorManager.pub.error_exit = errorExit;
+    errorManager.pub.output_message = outputMessage;
+
+    // volatile as it's modified between setjmp() and longjmp()
+    uint8_t* volatile pixels = nullptr;
+
+    if (setjmp(errorManager.setjmpBuffer))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        delete[] pixels;
+        return {};
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(data), static_cast<unsigned long>(size));
+    jpeg_read_header(&cinfo, TRUE);
+
+    // match the stb_image decoded layouts, grayscale as R8 and colour as RGBA or RGB depending on mapRGBtoRGBAHint.
+    uint32_t components = 0;
+    switch (cinfo.jpeg_color_space)
+    {
+    case JCS_GRAYSCALE:
+        cinfo.out_color_space = JCS_GRAYSCALE;
+        components = 1;
+        break;
+    case JCS_YCbCr:
+    case JCS_RGB:
+        cinfo.out_color_space = mapRGBtoRGBAHint ? JCS_EXT_RGBA : JCS_RGB;
+        components = mapRGBtoRGBAHint ? 4 : 3;
+        break;
+    default:
+        // leave CMYK/YCCK to stb_image
+        jpeg_destroy_decompress(&cinfo);
+        return {};
+    }
+
+    // libjpeg-turbo can scale by 1/2, 1/4 or 1/8 in the inverse DCT so the full resolution image is never reconstructed.
+    uint32_t factor = downsampleFactor(cinfo.image_width, cinfo.image_height, maxDimension);
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = std::min(factor, 8u);
+
+    jpeg_start_decompress(&cinfo);
+
+    const size_t rowSize = static_cast<size_t>(cinfo.output_width) * components;
+    pixels = new uint8_t[rowSize * cinfo.output_height];
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        JSAMPROW row = pixels + rowSize * cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+
+    const uint32_t width = cinfo.output_width;
+    const uint32_t height = cinfo.output_height;
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+
+    return createImage8(pixels, width, height, components);
+}
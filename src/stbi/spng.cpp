@@ -0,0 +1,88 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Decoders.h"
+
+#include <cstring>
+#include <memory>
+
+#include <spng.h>
+
+using namespace vsgXchange;
+
+vsg::ref_ptr<vsg::Data> vsgXchange::readPNG(const uint8_t* data, size_t size, bool mapRGBtoRGBAHint)
+{
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (size < sizeof(signature) || std::memcmp(data, signature, sizeof(signature)) != 0) return {};
+
+    std::unique_ptr<spng_ctx, decltype(&spng_ctx_free)> ctx(spng_ctx_new(0), spng_ctx_free);
+    if (!ctx || spng_set_png_buffer(ctx.get(), data, size) != 0) return {};
+
+    spng_ihdr ihdr;
+    if (spng_get_ihdr(ctx.get(), &ihdr) != 0) return {};
+
+    // 16 bit images keep their precision via stb_image's 16 bit path
+    if (ihdr.bit_depth > 8) return {};
+
+    // stb_image only reports tRNS transparency as an alpha channel for palette images, the tRNS of grayscale and RGB images is dropped when
+    // decoding to their native number of components, so only expand it for palette images to match.
+    spng_trns trns;
+    bool hasPaletteTransparency = (ihdr.color_type == SPNG_COLOR_TYPE_INDEXED) && (spng_get_trns(ctx.get(), &trns) == 0);
+
+    // match the number of components stb_image decodes to, with RGB mapped to RGBA depending on mapRGBtoRGBAHint.
+    int format = 0;
+    uint32_t components = 0;
+    switch (ihdr.color_type)
+    {
+    case SPNG_COLOR_TYPE_GRAYSCALE:
+        // leave low bit depth grayscale to stb_image, which scales it up to 8 bit.
+        if (ihdr.bit_depth != 8) return {};
+        format = SPNG_FMT_G8;
+        components = 1;
+        break;
+    case SPNG_COLOR_TYPE_GRAYSCALE_ALPHA:
+        format = SPNG_FMT_GA8;
+        components = 2;
+        break;
+    case SPNG_COLOR_TYPE_TRUECOLOR:
+    case SPNG_COLOR_TYPE_INDEXED:
+        if (hasPaletteTransparency || mapRGBtoRGBAHint)
+        {
+            format = SPNG_FMT_RGBA8;
+            components = 4;
+        }
+        else
+        {
+            format = SPNG_FMT_RGB8;
+            components = 3;
+        }
+        break;
+    case SPNG_COLOR_TYPE_TRUECOLOR_ALPHA:
+        format = SPNG_FMT_RGBA8;
+        components = 4;
+        break;
+    default:
+        return {};
+    }
+
+    size_t imageSize = 0;
+    if (spng_decoded_image_size(ctx.get(), format, &imageSize) != 0) return {};
+
+    auto pixels = new uint8_t[imageSize];
+    if (spng_decode_image(ctx.get(), pixels, imageSize, format, hasPaletteTransparency ? SPNG_DECODE_TRNS : 0) != 0)
+    {
+        delete[] pixels;
+        return {};
+    }
+
+    return createImage8(pixels, ihdr.width, ihdr.height, components);
+}
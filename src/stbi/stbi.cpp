@@ -15,6 +15,14 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include <vsg/io/FileSystem.h>
 #include <vsg/io/ObjectCache.h>
 
+#include "../utils/Downsample.h"
+#include "../utils/InputBuffer.h"
+#include "../utils/MappedFile.h"
+#include "../utils/Mipmaps.h"
+#include "../utils/PixelConversion.h"
+#include "Decoders.h"
+
+#include <climits>
 #include <cstring>
 
 #include <iostream>
@@ -69,8 +77,210 @@ void cpp_free(void* ptr)
 
 using namespace vsgXchange;
 
+namespace
+{
+    /// how an image is decoded, the number of components and whether they are 8 bit, 16 bit or float.
+    struct ImageType
+    {
+        int components = 4;
+        int decodeComponents = 4; // components requested from stbi, 8 bit RGB is expanded to RGBA with convertRGBtoRGBA()
+        bool is16Bit = false;
+        bool isHDR = false;
+    };
+
+    ImageType imageType(int channels, bool is16Bit, bool isHDR, const vsg::Options* options)
+    {
+        // keep the native number of channels apart from RGB, which maps to RGBA as most GPUs don't support sampling 3 component formats.
+        bool mapRGBtoRGBAHint = !options || options->mapRGBtoRGBAHint;
+        int components = (channels == 3 && mapRGBtoRGBAHint) ? 4 : channels;
+        bool is8Bit = !is16Bit && !isHDR;
+        int decodeComponents = (channels == 3 && is8Bit) ? 3 : components;
+        return ImageType{components, decodeComponents, is16Bit && !isHDR, isHDR};
+    }
+
+    VkFormat imageFormat(const ImageType& type)
+    {
+        static const VkFormat formats_8bit[4] = {VK_FORMAT_R8_UNORM, VK_FORMAT_R8G8_UNORM, VK_FORMAT_R8G8B8_UNORM, VK_FORMAT_R8G8B8A8_UNORM};
+        static const VkFormat formats_16bit[4] = {VK_FORMAT_R16_UNORM, VK_FORMAT_R16G16_UNORM, VK_FORMAT_R16G16B16_UNORM, VK_FORMAT_R16G16B16A16_UNORM};
+        static const VkFormat formats_float[4] = {VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+
+        if (type.components < 1 || type.components > 4) return VK_FORMAT_UNDEFINED;
+        if (type.isHDR) return formats_float[type.components - 1];
+        if (type.is16Bit) return formats_16bit[type.components - 1];
+        return formats_8bit[type.components - 1];
+    }
+
+    template<typename T1, typename T2, typename T3, typename T4>
+    vsg::ref_ptr<vsg::Data> createImage(void* pixels, int width, int height, int components, vsg::Data::Layout layout)
+    {
+        switch (components)
+        {
+        case 1: return vsg::Array2D<T1>::create(width, height, static_cast<T1*>(pixels), layout);
+        case 2: return vsg::Array2D<T2>::create(width, height, static_cast<T2*>(pixels), layout);
+        case 3: return vsg::Array2D<T3>::create(width, height, static_cast<T3*>(pixels), layout);
+        case 4: return vsg::Array2D<T4>::create(width, height, static_cast<T4*>(pixels), layout);
+        default: return {};
+        }
+    }
+
+    /// wrap the pixels decoded by stbi in a vsg::Data, taking ownership of them.
+    vsg::ref_ptr<vsg::Data> createImage(void* pixels, int width, int height, const ImageType& type)
+    {
+        if (!pixels) return {};
+
+        if (type.decodeComponents != type.components)
+        {
+            auto rgba = new uint8_t[static_cast<size_t>(width) * height * 4];
+            convertRGBtoRGBA(static_cast<const uint8_t*>(pixels), rgba, static_cast<size_t>(width) * height);
+            stbi_image_free(pixels);
+            pixels = rgba;
+        }
+
+        vsg::Data::Layout layout{imageFormat(type)};
+        if (type.isHDR) return createImage<float, vsg::vec2, vsg::vec3, vsg::vec4>(pixels, width, height, type.components, layout);
+        if (type.is16Bit) return createImage<uint16_t, vsg::usvec2, vsg::usvec3, vsg::usvec4>(pixels, width, height, type.components, layout);
+        return createImage<uint8_t, vsg::ubvec2, vsg::ubvec3, vsg::ubvec4>(pixels, width, height, type.components, layout);
+    }
+
+    uint32_t maxDimension(const vsg::Options* options)
+    {
+        uint32_t value = 0;
+        if (options) options->getValue(stbi::max_dimension, value);
+        return value;
+    }
+
+    /// box filter images down by a power of two so that neither dimension exceeds the stbi::max_dimension option.
+    vsg::ref_ptr<vsg::Data> limitDimensions(vsg::ref_ptr<vsg::Data> image, const vsg::Options* options)
+    {
+        if (!image) return image;
+
+        uint32_t factor = downsampleFactor(image->width(), image->height(), maxDimension(options));
+        if (factor == 1) return image;
+
+        if (auto reduced = downsample(*image, factor)) return reduced;
+        return image;
+    }
+
+    vsg::ref_ptr<ImageInfo> createImageInfo(int width, int height, const ImageType& type, const vsg::Options* options)
+    {
+        uint32_t factor = downsampleFactor(static_cast<uint32_t>(width), static_cast<uint32_t>(height), maxDimension(options));
+
+        auto info = ImageInfo::create();
+        info->layout.format = imageFormat(type);
+        info->width = downsampledSize(static_cast<uint32_t>(width), factor);
+        info->height = downsampledSize(static_cast<uint32_t>(height), factor);
+        return info;
+    }
+
+    vsg::ref_ptr<vsg::Data> readImage(const stbi_uc* buffer, int length, const vsg::Options* options)
+    {
+        // use libjpeg-turbo and libspng when available as they are several times faster than stb_image,
+        // libjpeg-turbo also applies most of the max_dimension reduction during the inverse DCT.
+        bool mapRGBtoRGBAHint = !options || options->mapRGBtoRGBAHint;
+        if (auto data = readJPEG(buffer, static_cast<size_t>(length), mapRGBtoRGBAHint, maxDimension(options))) return limitDimensions(data, options);
+        if (auto data = readPNG(buffer, static_cast<size_t>(length), mapRGBtoRGBAHint)) return limitDimensions(data, options);
+
+        int width, height, channels;
+        if (!stbi_info_from_memory(buffer, length, &width, &height, &channels)) return {};
+
+        auto type = imageType(channels, stbi_is_16_bit_from_memory(buffer, length), stbi_is_hdr_from_memory(buffer, length), options);
+
+        void* pixels = nullptr;
+        if (type.isHDR)
+            pixels = stbi_loadf_from_memory(buffer, length, &width, &height, &channels, type.decodeComponents);
+        else if (type.is16Bit)
+            pixels = stbi_load_16_from_memory(buffer, length, &width, &height, &channels, type.decodeComponents);
+        else
+            pixels = stbi_load_from_memory(buffer, length, &width, &height, &channels, type.decodeComponents);
+
+        return limitDimensions(createImage(pixels, width, height, type), options);
+    }
+
+    vsg::ref_ptr<vsg::Data> readImage(FILE* file, const vsg::Options* options)
+    {
+        // the stbi_*_from_file() queries restore the file position after reading the header.
+        int width, height, channels;
+        if (!stbi_info_from_file(file, &width, &height, &channels)) return {};
+
+        auto type = imageType(channels, stbi_is_16_bit_from_file(file), stbi_is_hdr_from_file(file), options);
+
+        void* pixels = nullptr;
+        if (type.isHDR)
+            pixels = stbi_loadf_from_file(file, &width, &height, &channels, type.decodeComponents);
+        else if (type.is16Bit)
+            pixels = stbi_load_from_file_16(file, &width, &height, &channels, type.decodeComponents);
+        else
+            pixels = stbi_load_from_file(file, &width, &height, &channels, type.decodeComponents);
+
+        return limitDimensions(createImage(pixels, width, height, type), options);
+    }
+
+    vsg::ref_ptr<ImageInfo> probeImage(const stbi_uc* buffer, int length, const vsg::Options* options)
+    {
+        int width, height, channels;
+        if (!stbi_info_from_memory(buffer, length, &width, &height, &channels)) return {};
+        return createImageInfo(width, height, imageType(channels, stbi_is_16_bit_from_memory(buffer, length), stbi_is_hdr_from_memory(buffer, length), options), options);
+    }
+
+    vsg::ref_ptr<ImageInfo> probeImage(FILE* file, const vsg::Options* options)
+    {
+        int width, height, channels;
+        if (!stbi_info_from_file(file, &width, &height, &channels)) return {};
+        return createImageInfo(width, height, imageType(channels, stbi_is_16_bit_from_file(file), stbi_is_hdr_from_file(file), options), options);
+    }
+
+    // stbi_io_callbacks that pull just the header bytes from the stream.
+    int istream_read(void* user, char* data, int size)
+    {
+        auto& fin = *static_cast<std::istream*>(user);
+        fin.read(data, size);
+        return static_cast<int>(fin.gcount());
+    }
+
+    void istream_skip(void* user, int n)
+    {
+        if (n > 0) static_cast<std::istream*>(user)->ignore(n);
+    }
+
+    int istream_eof(void* user)
+    {
+        return static_cast<std::istream*>(user)->eof() ? 1 : 0;
+    }
+
+    const stbi_io_callbacks istream_callbacks{istream_read, istream_skip, istream_eof};
+
+    vsg::ref_ptr<ImageInfo> probeImage(std::istream& fin, const vsg::Options* options)
+    {
+        // each stbi query reads the header from the start so rewind the stream between them,
+        // streams that can't be repositioned are read into memory.
+        auto start = fin.tellg();
+        if (start == std::streampos(-1))
+        {
+            InputBuffer input(fin);
+            return probeImage(reinterpret_cast<const stbi_uc*>(input.data()), static_cast<int>(input.size()), options);
+        }
+
+        auto rewind = [&]() {
+            fin.clear();
+            fin.seekg(start);
+        };
+
+        int width, height, channels;
+        bool valid = stbi_info_from_callbacks(&istream_callbacks, &fin, &width, &height, &channels) != 0;
+        rewind();
+        if (!valid) return {};
+
+        bool is16Bit = stbi_is_16_bit_from_callbacks(&istream_callbacks, &fin) != 0;
+        rewind();
+        bool isHDR = stbi_is_hdr_from_callbacks(&istream_callbacks, &fin) != 0;
+        rewind();
+
+        return createImageInfo(width, height, imageType(channels, is16Bit, isHDR, options), options);
+    }
+} // namespace
+
 stbi::stbi() :
-    _supportedExtensions{".jpg", ".jpeg", ".jpe", ".png", ".gif", ".bmp", ".tga", ".psd", ".pgm", ".ppm"}
+    _supportedExtensions{".jpg", ".jpeg", ".jpe", ".png", ".gif", ".bmp", ".tga", ".psd", ".pgm", ".ppm", ".hdr"}
 {
 }
 
@@ -84,16 +294,29 @@ vsg::ref_ptr<vsg::Object> stbi::read(const vsg::Path& filename, vsg::ref_ptr<con
     vsg::Path filenameToUse = findFile(filename, options);
     if (filenameToUse.empty()) return {};
 
-    int width, height, channels;
-    const auto pixels = stbi_load(filenameToUse.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-    if (pixels)
+    bool probe = vsg::value<bool>(false, images::probe, options);
+    if (!probe)
     {
-        auto vsg_data = vsg::ubvec4Array2D::create(width, height, reinterpret_cast<vsg::ubvec4*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8B8A8_UNORM});
-
-        return vsg_data;
+        if (MappedFile mappedFile(filenameToUse); mappedFile.valid() && mappedFile.size() <= INT_MAX)
+        {
+            // decode directly from the page cache rather than through stdio buffering
+            return generateMipmaps(readImage(mappedFile.data(), static_cast<int>(mappedFile.size()), options.get()), options.get());
+        }
     }
 
-    return {};
+    // stbi__fopen handles UTF-8 filenames on Windows
+    FILE* file = stbi__fopen(filenameToUse.c_str(), "rb");
+    if (!file) return {};
+
+    vsg::ref_ptr<vsg::Object> result;
+    if (probe)
+        result = probeImage(file, options.get());
+    else
+        result = generateMipmaps(readImage(file, options.get()), options.get());
+
+    fclose(file);
+
+    return result;
 }
 
 vsg::ref_ptr<vsg::Object> stbi::read(std::istream& fin, vsg::ref_ptr<const vsg::Options> options) const
@@ -101,25 +324,11 @@ vsg::ref_ptr<vsg::Object> stbi::read(std::istream& fin, vsg::ref_ptr<const vsg::
     if (!options || _supportedExtensions.count(options->extensionHint) == 0)
         return {};
 
-    std::string buffer(1 << 16, 0); // 64kB
-    std::string input;
+    if (vsg::value<bool>(false, images::probe, options)) return probeImage(fin, options.get());
 
-    while (!fin.eof())
-    {
-        fin.read(&buffer[0], buffer.size());
-        const auto bytes_readed = fin.gcount();
-        input.append(&buffer[0], bytes_readed);
-    }
+    InputBuffer input(fin);
 
-    int width, height, channels;
-    const auto pixels = stbi_load_from_memory(reinterpret_cast<stbi_uc*>(input.data()), static_cast<int>(input.size()), &width, &height, &channels, STBI_rgb_alpha);
-    if (pixels)
-    {
-        auto vsg_data = vsg::ubvec4Array2D::create(width, height, reinterpret_cast<vsg::ubvec4*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8B8A8_UNORM});
-        return vsg_data;
-    }
-
-    return {};
+    return generateMipmaps(readImage(reinterpret_cast<const stbi_uc*>(input.data()), static_cast<int>(input.size()), options.get()), options.get());
 }
 
 vsg::ref_ptr<vsg::Object> stbi::read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options) const
@@ -127,15 +336,9 @@ vsg::ref_ptr<vsg::Object> stbi::read(const uint8_t* ptr, size_t size, vsg::ref_p
     if (!options || _supportedExtensions.count(options->extensionHint) == 0)
         return {};
 
-    int width, height, channels;
-    const auto pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(ptr), static_cast<int>(size), &width, &height, &channels, STBI_rgb_alpha);
-    if (pixels)
-    {
-        auto vsg_data = vsg::ubvec4Array2D::create(width, height, reinterpret_cast<vsg::ubvec4*>(pixels), vsg::Data::Layout{VK_FORMAT_R8G8B8A8_UNORM});
-        return vsg_data;
-    }
+    if (vsg::value<bool>(false, images::probe, options)) return probeImage(reinterpret_cast<const stbi_uc*>(ptr), static_cast<int>(size), options.get());
 
-    return {};
+    return generateMipmaps(readImage(reinterpret_cast<const stbi_uc*>(ptr), static_cast<int>(size), options.get()), options.get());
 }
 
 bool stbi::getFeatures(Features& features) const
@@ -144,5 +347,24 @@ bool stbi::getFeatures(Features& features) const
     {
         features.extensionFeatureMap[ext] = static_cast<vsg::ReaderWriter::FeatureMask>(vsg::ReaderWriter::READ_FILENAME | vsg::ReaderWriter::READ_ISTREAM | vsg::ReaderWriter::READ_MEMORY);
     }
+
+    features.optionNameTypeMap[images::probe] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::generate_mipmaps] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_filter] = vsg::type_name<std::string>();
+    features.optionNameTypeMap[images::mipmap_srgb] = vsg::type_name<bool>();
+    features.optionNameTypeMap[images::mipmap_threads] = vsg::type_name<uint32_t>();
+    features.optionNameTypeMap[stbi::max_dimension] = vsg::type_name<uint32_t>();
+
     return true;
 }
+
+bool stbi::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
+{
+    bool result = arguments.readAndAssign<void>(images::probe, &options);
+    result = arguments.readAndAssign<void>(images::generate_mipmaps, &options) || result;
+    result = arguments.readAndAssign<std::string>(images::mipmap_filter, &options) || result;
+    result = arguments.readAndAssign<void>(images::mipmap_srgb, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(images::mipmap_threads, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(stbi::max_dimension, &options) || result;
+    return result;
+}
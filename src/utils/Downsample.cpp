@@ -0,0 +1,118 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Downsample.h"
+
+#include <vsg/core/Array2D.h>
+
+#include <algorithm>
+#include <type_traits>
+
+using namespace vsgXchange;
+
+namespace
+{
+    template<typename T, typename Sum>
+    void downsampleBlocks(const T* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, T* dst)
+    {
+        const uint32_t new_width = downsampledSize(width, factor);
+        const uint32_t new_height = downsampledSize(height, factor);
+        const size_t rowSize = static_cast<size_t>(width) * components;
+
+        Sum sums[4];
+        for (uint32_t r = 0; r < new_height; ++r)
+        {
+            const uint32_t row_begin = r * factor;
+            const uint32_t row_end = std::min(row_begin + factor, height);
+            for (uint32_t c = 0; c < new_width; ++c)
+            {
+                const uint32_t column_begin = c * factor;
+                const uint32_t column_end = std::min(column_begin + factor, width);
+
+                std::fill(sums, sums + components, Sum(0));
+                for (uint32_t row = row_begin; row < row_end; ++row)
+                {
+                    const T* texel = src + row * rowSize + static_cast<size_t>(column_begin) * components;
+                    for (uint32_t column = column_begin; column < column_end; ++column)
+                    {
+                        for (uint32_t i = 0; i < components; ++i) sums[i] += *(texel++);
+                    }
+                }
+
+                const Sum count = static_cast<Sum>((row_end - row_begin) * (column_end - column_begin));
+                for (uint32_t i = 0; i < components; ++i)
+                {
+                    if constexpr (std::is_floating_point_v<Sum>)
+                        *(dst++) = static_cast<T>(sums[i] / count);
+                    else
+                        *(dst++) = static_cast<T>((sums[i] + count / 2) / count);
+                }
+            }
+        }
+    }
+
+    template<typename V, typename T>
+    vsg::ref_ptr<vsg::Data> downsampleImage(const vsg::Data& image, uint32_t components, uint32_t factor)
+    {
+        auto layout = image.getLayout();
+        layout.maxNumMipmaps = 0;
+
+        auto new_image = vsg::Array2D<V>::create(downsampledSize(image.width(), factor), downsampledSize(image.height(), factor), layout);
+        downsample(static_cast<const T*>(image.dataPointer()), image.width(), image.height(), components, factor, static_cast<T*>(new_image->dataPointer()));
+        return new_image;
+    }
+} // namespace
+
+uint32_t vsgXchange::downsampleFactor(uint32_t width, uint32_t height, uint32_t maxDimension)
+{
+    uint32_t factor = 1;
+    if (maxDimension == 0) return factor;
+
+    const uint32_t dimension = std::max(width, height);
+    while (downsampledSize(dimension, factor) > maxDimension) factor *= 2;
+    return factor;
+}
+
+void vsgXchange::downsample(const uint8_t* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, uint8_t* dst)
+{
+    downsampleBlocks<uint8_t, uint32_t>(src, width, height, components, factor, dst);
+}
+
+void vsgXchange::downsample(const uint16_t* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, uint16_t* dst)
+{
+    downsampleBlocks<uint16_t, uint64_t>(src, width, height, components, factor, dst);
+}
+
+void vsgXchange::downsample(const float* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, float* dst)
+{
+    downsampleBlocks<float, double>(src, width, height, components, factor, dst);
+}
+
+vsg::ref_ptr<vsg::Data> vsgXchange::downsample(const vsg::Data& image, uint32_t factor)
+{
+    switch (image.getLayout().format)
+    {
+    case VK_FORMAT_R8_UNORM: return downsampleImage<uint8_t, uint8_t>(image, 1, factor);
+    case VK_FORMAT_R8G8_UNORM: return downsampleImage<vsg::ubvec2, uint8_t>(image, 2, factor);
+    case VK_FORMAT_R8G8B8_UNORM: return downsampleImage<vsg::ubvec3, uint8_t>(image, 3, factor);
+    case VK_FORMAT_R8G8B8A8_UNORM: return downsampleImage<vsg::ubvec4, uint8_t>(image, 4, factor);
+    case VK_FORMAT_R16_UNORM: return downsampleImage<uint16_t, uint16_t>(image, 1, factor);
+    case VK_FORMAT_R16G16_UNORM: return downsampleImage<vsg::usvec2, uint16_t>(image, 2, factor);
+    case VK_FORMAT_R16G16B16_UNORM: return downsampleImage<vsg::usvec3, uint16_t>(image, 3, factor);
+    case VK_FORMAT_R16G16B16A16_UNORM: return downsampleImage<vsg::usvec4, uint16_t>(image, 4, factor);
+    case VK_FORMAT_R32_SFLOAT: return downsampleImage<float, float>(image, 1, factor);
+    case VK_FORMAT_R32G32_SFLOAT: return downsampleImage<vsg::vec2, float>(image, 2, factor);
+    case VK_FORMAT_R32G32B32_SFLOAT: return downsampleImage<vsg::vec3, float>(image, 3, factor);
+    case VK_FORMAT_R32G32B32A32_SFLOAT: return downsampleImage<vsg::vec4, float>(image, 4, factor);
+    default: return {};
+    }
+}
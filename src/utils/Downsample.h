@@ -0,0 +1,38 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/core/Data.h>
+
+#include <cstdint>
+
+namespace vsgXchange
+{
+
+    /// return the power of two factor that reduces width and height so that neither exceeds maxDimension, 1 if maxDimension is 0 or already satisfied.
+    uint32_t downsampleFactor(uint32_t width, uint32_t height, uint32_t maxDimension);
+
+    /// size of a dimension reduced by factor, partial blocks at the right and bottom edges are kept.
+    inline uint32_t downsampledSize(uint32_t size, uint32_t factor) { return (size + factor - 1) / factor; }
+
+    /// box filter factor x factor blocks of texels from src into dst, which must hold downsampledSize(width, factor) x downsampledSize(height, factor) texels.
+    /// Partial blocks at the right and bottom edges average the texels available.
+    void downsample(const uint8_t* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, uint8_t* dst);
+    void downsample(const uint16_t* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, uint16_t* dst);
+    void downsample(const float* src, uint32_t width, uint32_t height, uint32_t components, uint32_t factor, float* dst);
+
+    /// return a box filtered copy of a 2D image reduced by factor, supports the 8 bit and 16 bit UNORM and 32 bit SFLOAT R to RGBA formats.
+    /// Returns null if the format isn't supported.
+    vsg::ref_ptr<vsg::Data> downsample(const vsg::Data& image, uint32_t factor);
+
+} // namespace vsgXchange
@@ -0,0 +1,80 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "InputBuffer.h"
+
+#include <algorithm>
+#include <streambuf>
+
+using namespace vsgXchange;
+
+namespace
+{
+    // the get area pointers of std::streambuf are protected, taking their address through a derived class
+    // yields member pointers of std::streambuf that can be applied to any stream buffer.
+    struct GetArea : public std::streambuf
+    {
+        using std::streambuf::egptr;
+        using std::streambuf::gptr;
+    };
+
+    const char* gptr(std::streambuf* buffer) { return (buffer->*(&GetArea::gptr))(); }
+    const char* egptr(std::streambuf* buffer) { return (buffer->*(&GetArea::egptr))(); }
+} // namespace
+
+InputBuffer::InputBuffer(std::istream& fin)
+{
+    // determine how many bytes remain, the seek also brings std::stringbuf's get area up to date with anything written to it.
+    std::streamoff remaining = -1;
+    auto start = fin.tellg();
+    if (start != std::streampos(-1) && fin.seekg(0, std::ios::end))
+    {
+        auto end = fin.tellg();
+        fin.seekg(start);
+        if (end != std::streampos(-1)) remaining = end - start;
+    }
+    fin.clear(fin.rdstate() & ~std::ios::failbit);
+
+    auto buffer = fin.rdbuf();
+    if (remaining > 0 && buffer && (egptr(buffer) - gptr(buffer)) == remaining)
+    {
+        // the stream's buffer holds all the remaining bytes so use them in place.
+        _data = gptr(buffer);
+        _size = static_cast<size_t>(remaining);
+        fin.seekg(0, std::ios::end);
+        return;
+    }
+
+    if (remaining > 0)
+    {
+        _storage.resize(static_cast<size_t>(remaining));
+        fin.read(&_storage[0], remaining);
+        _storage.resize(static_cast<size_t>(fin.gcount()));
+
+        // check for the end of the stream so the storage isn't grown unnecessarily
+        fin.peek();
+    }
+
+    // read anything beyond the reported length, or everything when the stream isn't seekable, directly into the storage.
+    size_t chunkSize = 1 << 16; // 64kB
+    while (fin.good())
+    {
+        size_t previousSize = _storage.size();
+        _storage.resize(previousSize + chunkSize);
+        fin.read(&_storage[previousSize], chunkSize);
+        _storage.resize(previousSize + static_cast<size_t>(fin.gcount()));
+        chunkSize = std::max(chunkSize, previousSize / 2);
+    }
+
+    _data = _storage.data();
+    _size = _storage.size();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <cstdint>
+#include <istream>
+#include <string>
+
+namespace vsgXchange
+{
+
+    /// Contiguous view of the remaining contents of an input stream, for passing streams to decoders that read from memory.
+    /// When the stream's buffer already holds all the remaining bytes, as with std::stringstream, the view refers directly to them,
+    /// otherwise the contents are read into storage sized from the stream length where the stream is seekable.
+    /// The stream is left at its end and must outlive the InputBuffer.
+    class InputBuffer
+    {
+    public:
+        explicit InputBuffer(std::istream& fin);
+
+        InputBuffer(const InputBuffer&) = delete;
+        InputBuffer& operator=(const InputBuffer&) = delete;
+
+        const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(_data); }
+        size_t size() const { return _size; }
+
+        /// true if data() refers directly to the stream's buffer rather than a copy.
+        bool isView() const { return _storage.empty() && _size > 0; }
+
+    protected:
+        std::string _storage;
+        const char* _data = nullptr;
+        size_t _size = 0;
+    };
+
+} // namespace vsgXchange
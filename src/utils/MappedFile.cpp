@@ -0,0 +1,139 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+using namespace vsgXchange;
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const vsg::Path& filename)
+{
+    HANDLE fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    if (static_cast<size_t>(fileSize.QuadPart) < minimumMappedSize)
+    {
+        DWORD numBytesRead = 0;
+        _buffer.reset(new uint8_t[static_cast<size_t>(fileSize.QuadPart)]);
+        if (ReadFile(fileHandle, _buffer.get(), static_cast<DWORD>(fileSize.QuadPart), &numBytesRead, nullptr) && numBytesRead == static_cast<DWORD>(fileSize.QuadPart))
+        {
+            _data = _buffer.get();
+            _size = static_cast<size_t>(fileSize.QuadPart);
+        }
+        else
+        {
+            _buffer.reset();
+        }
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle)
+    {
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    auto ptr = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!ptr)
+    {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    _fileHandle = fileHandle;
+    _mappingHandle = mappingHandle;
+    _data = static_cast<const uint8_t*>(ptr);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data && !_buffer) UnmapViewOfFile(_data);
+    if (_mappingHandle) CloseHandle(_mappingHandle);
+    if (_fileHandle) CloseHandle(_fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const vsg::Path& filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat status;
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        size_t size = static_cast<size_t>(status.st_size);
+        if (size < minimumMappedSize)
+        {
+            _buffer.reset(new uint8_t[size]);
+            if (::read(fd, _buffer.get(), size) == status.st_size)
+            {
+                _data = _buffer.get();
+                _size = size;
+            }
+            else
+            {
+                _buffer.reset();
+            }
+        }
+        else
+        {
+            void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (ptr != MAP_FAILED)
+            {
+                // decoders read the whole file front to back so ask for aggressive read ahead.
+                madvise(ptr, size, MADV_SEQUENTIAL);
+                madvise(ptr, size, MADV_WILLNEED);
+
+                _data = static_cast<const uint8_t*>(ptr);
+                _size = size;
+            }
+        }
+    }
+
+    // the mapping holds its own reference to the file
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data && !_buffer) munmap(const_cast<uint8_t*>(_data), _size);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/FileSystem.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace vsgXchange
+{
+
+    /// Read only memory mapping of a whole file, so decoders that read from memory can be fed directly from the page cache
+    /// without first copying the file into an intermediate buffer. valid() returns false if the file couldn't be mapped,
+    /// in which case callers should fall back to reading the file conventionally.
+    /// Files smaller than minimumMappedSize are read into a buffer instead, as setting up and tearing down a mapping costs more than copying them.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const vsg::Path& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        static constexpr size_t minimumMappedSize = 256 * 1024;
+
+        bool valid() const { return _data != nullptr; }
+
+        const uint8_t* data() const { return _data; }
+        size_t size() const { return _size; }
+
+    protected:
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+        std::unique_ptr<uint8_t[]> _buffer;
+#if defined(_WIN32)
+        void* _fileHandle = nullptr;
+        void* _mappingHandle = nullptr;
+#endif
+    };
+
+} // namespace vsgXchange
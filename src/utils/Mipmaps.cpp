@@ -0,0 +1,379 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Mipmaps.h"
+#include "Parallel.h"
+
+#include <vsgXchange/images.h>
+
+#include <vsg/core/Array2D.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace vsgXchange;
+
+namespace
+{
+    /// source texels, starting at first, and their weights for a texel of the next mipmap level along one axis.
+    struct Taps
+    {
+        uint32_t first = 0;
+        std::vector<float> weights;
+    };
+
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32 && term > sum * 1e-12; ++k)
+        {
+            double t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+        }
+        return sum;
+    }
+
+    double sinc(double x)
+    {
+        if (std::abs(x) < 1e-6) return 1.0;
+        x *= 3.14159265358979323846;
+        return std::sin(x) / x;
+    }
+
+    std::vector<Taps> computeTaps(uint32_t sourceSize, uint32_t size, MipmapSettings::Filter filter)
+    {
+        // Kaiser windowed sinc with a radius of 2 texels of the next level, alpha = 4 gives a good balance of sharpness and ringing.
+        const double radius = 2.0;
+        const double alpha = 4.0;
+
+        const double scale = static_cast<double>(sourceSize) / static_cast<double>(size);
+
+        std::vector<Taps> taps(size);
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            auto& tap = taps[x];
+            if (sourceSize == size)
+            {
+                tap.first = x;
+                tap.weights.assign(1, 1.0f);
+                continue;
+            }
+
+            const double center = (x + 0.5) * scale;
+            const double begin = (filter == MipmapSettings::BOX) ? x * scale : center - radius * scale;
+            const double end = (filter == MipmapSettings::BOX) ? (x + 1) * scale : center + radius * scale;
+
+            // texels beyond the edges are clamped to the edge texels
+            const int64_t first = static_cast<int64_t>(std::floor(begin));
+            const int64_t last = static_cast<int64_t>(std::ceil(end)) - 1;
+            auto clamp = [&](int64_t i) { return static_cast<uint32_t>(std::clamp<int64_t>(i, 0, sourceSize - 1)); };
+
+            tap.first = clamp(first);
+            std::vector<double> weights(clamp(last) - tap.first + 1, 0.0);
+            double total = 0.0;
+            for (int64_t i = first; i <= last; ++i)
+            {
+                double weight = 0.0;
+                if (filter == MipmapSettings::BOX)
+                {
+                    weight = std::min(end, static_cast<double>(i + 1)) - std::max(begin, static_cast<double>(i));
+                }
+                else
+                {
+                    double d = (i + 0.5 - center) / scale;
+                    if (std::abs(d) < radius)
+                    {
+                        double r = d / radius;
+                        weight = sinc(d) * besselI0(alpha * std::sqrt(1.0 - r * r)) / besselI0(alpha);
+                    }
+                }
+
+                weights[clamp(i) - tap.first] += weight;
+                total += weight;
+            }
+
+            tap.weights.resize(weights.size());
+            for (size_t i = 0; i < weights.size(); ++i) tap.weights[i] = static_cast<float>(weights[i] / total);
+        }
+        return taps;
+    }
+
+    float srgbToLinear(float c)
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float c)
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    /// convert a row of texels to floats, sRGB encoded components are converted to linear.
+    template<typename T>
+    void decodeRow(const T* src, uint32_t width, uint32_t components, const bool* linearize, float* dst)
+    {
+        if constexpr (std::is_same_v<T, uint8_t>)
+        {
+            static const auto tables = []() {
+                std::vector<float> values(512);
+                for (int i = 0; i < 256; ++i)
+                {
+                    values[i] = static_cast<float>(i) / 255.0f;
+                    values[256 + i] = srgbToLinear(values[i]);
+                }
+                return values;
+            }();
+
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t c = 0; c < components; ++c) *(dst++) = tables[(linearize[c] ? 256 : 0) + *(src++)];
+            }
+        }
+        else if constexpr (std::is_same_v<T, uint16_t>)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    float value = static_cast<float>(*(src++)) / 65535.0f;
+                    *(dst++) = linearize[c] ? srgbToLinear(value) : value;
+                }
+            }
+        }
+        else
+        {
+            std::copy(src, src + static_cast<size_t>(width) * components, dst);
+        }
+    }
+
+    /// convert a row of filtered floats back to texels, clamping and rounding UNORM components.
+    template<typename T>
+    void encodeRow(const float* src, uint32_t width, uint32_t components, const bool* linearize, T* dst)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            std::copy(src, src + static_cast<size_t>(width) * components, dst);
+        }
+        else
+        {
+            // linear values at the midpoints between sRGB encoded 8 bit values, with a coarse table of starting points into them,
+            // so encoding is a lookup and a short search rather than a pow() per component
+            static const auto thresholds = []() {
+                std::vector<float> values(256, 2.0f);
+                for (int i = 0; i < 255; ++i) values[i] = srgbToLinear((static_cast<float>(i) + 0.5f) / 255.0f);
+                return values;
+            }();
+            static const auto starts = []() {
+                std::vector<uint8_t> values(4096);
+                for (int i = 0; i < 4096; ++i)
+                {
+                    values[i] = static_cast<uint8_t>(std::upper_bound(thresholds.begin(), thresholds.begin() + 255, static_cast<float>(i) / 4095.0f) - thresholds.begin());
+                }
+                return values;
+            }();
+
+            const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t c = 0; c < components; ++c)
+                {
+                    float value = std::clamp(*(src++), 0.0f, 1.0f);
+                    if (!linearize[c])
+                        *(dst++) = static_cast<T>(value * maxValue + 0.5f);
+                    else if constexpr (std::is_same_v<T, uint8_t>)
+                    {
+                        uint32_t encoded = starts[static_cast<uint32_t>(value * 4095.0f)];
+                        while (value >= thresholds[encoded]) ++encoded;
+                        *(dst++) = static_cast<T>(encoded);
+                    }
+                    else
+                        *(dst++) = static_cast<T>(linearToSrgb(value) * maxValue + 0.5f);
+                }
+            }
+        }
+    }
+
+    uint32_t computeNumLevels(uint32_t width, uint32_t height)
+    {
+        uint32_t numLevels = 1;
+        for (uint32_t dimension = std::max(width, height); dimension > 1; dimension /= 2) ++numLevels;
+        return numLevels;
+    }
+
+    /// filter each mipmap level from the previous one, keeping the levels as floats so rounding errors don't accumulate down the chain.
+    template<typename T>
+    void generateLevels(const T* base, uint32_t width, uint32_t height, uint32_t components, bool srgbFormat, uint32_t numLevels, const MipmapSettings& settings, T* dst)
+    {
+        // colour components are filtered in linear space, alpha is always linear
+        bool linearize[4] = {false, false, false, false};
+        if (srgbFormat || (settings.srgb && std::is_same_v<T, uint8_t>))
+        {
+            uint32_t numColourComponents = (components == 2 || components == 4) ? components - 1 : components;
+            for (uint32_t c = 0; c < numColourComponents; ++c) linearize[c] = true;
+        }
+
+        std::copy(base, base + static_cast<size_t>(width) * height * components, dst);
+        T* level = dst + static_cast<size_t>(width) * height * components;
+
+        // only spread images across threads when they are big enough to amortize starting them
+        uint32_t numThreads = settings.maxThreads != 0 ? settings.maxThreads : std::thread::hardware_concurrency();
+        if (static_cast<size_t>(width) * height < 256 * 256) numThreads = 1;
+        const uint32_t stripHeight = 32;
+
+        std::vector<float> current, next;
+        for (uint32_t levelIndex = 1; levelIndex < numLevels; ++levelIndex)
+        {
+            const uint32_t new_width = std::max(1u, width / 2);
+            const uint32_t new_height = std::max(1u, height / 2);
+            const size_t rowSize = static_cast<size_t>(width) * components;
+            const size_t new_rowSize = static_cast<size_t>(new_width) * components;
+
+            const auto xTaps = computeTaps(width, new_width, settings.filter);
+            const auto yTaps = computeTaps(height, new_height, settings.filter);
+
+            // each strip of rows filters the source rows it needs horizontally into a local buffer, then filters those vertically,
+            // keeping the working set small rather than holding a horizontally filtered copy of the whole level.
+            next.resize(new_rowSize * new_height);
+            const uint32_t numStrips = (new_height + stripHeight - 1) / stripHeight;
+            parallelFor(numStrips, numThreads, [&](uint32_t strip) {
+                const uint32_t begin = strip * stripHeight;
+                const uint32_t end = std::min(begin + stripHeight, new_height);
+                const uint32_t sourceBegin = yTaps[begin].first;
+                const uint32_t sourceEnd = yTaps[end - 1].first + static_cast<uint32_t>(yTaps[end - 1].weights.size());
+
+                std::vector<float> decoded(levelIndex == 1 ? rowSize : 0);
+                std::vector<float> horizontal(new_rowSize * (sourceEnd - sourceBegin));
+                for (uint32_t r = sourceBegin; r < sourceEnd; ++r)
+                {
+                    const float* row = current.data() + r * rowSize;
+                    if (levelIndex == 1)
+                    {
+                        decodeRow(base + r * rowSize, width, components, linearize, decoded.data());
+                        row = decoded.data();
+                    }
+
+                    float* out = horizontal.data() + (r - sourceBegin) * new_rowSize;
+                    for (auto& tap : xTaps)
+                    {
+                        float sums[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+                        const float* texel = row + static_cast<size_t>(tap.first) * components;
+                        for (float weight : tap.weights)
+                        {
+                            for (uint32_t c = 0; c < components; ++c) sums[c] += weight * *(texel++);
+                        }
+                        for (uint32_t c = 0; c < components; ++c) *(out++) = sums[c];
+                    }
+                }
+
+                for (uint32_t r = begin; r < end; ++r)
+                {
+                    auto& tap = yTaps[r];
+                    float* out = next.data() + r * new_rowSize;
+                    std::fill(out, out + new_rowSize, 0.0f);
+                    for (size_t i = 0; i < tap.weights.size(); ++i)
+                    {
+                        const float weight = tap.weights[i];
+                        const float* row = horizontal.data() + (tap.first + i - sourceBegin) * new_rowSize;
+                        for (size_t j = 0; j < new_rowSize; ++j) out[j] += weight * row[j];
+                    }
+                    encodeRow(out, new_width, components, linearize, level + r * new_rowSize);
+                }
+            });
+
+            level += new_rowSize * new_height;
+            current.swap(next);
+            width = new_width;
+            height = new_height;
+        }
+    }
+
+    template<typename V, typename T>
+    vsg::ref_ptr<vsg::Data> createMipmappedImage(const vsg::Data& image, uint32_t components, bool srgbFormat, const MipmapSettings& settings)
+    {
+        const uint32_t width = image.width();
+        const uint32_t height = image.height();
+        const uint32_t numLevels = computeNumLevels(width, height);
+
+        size_t valueCount = 0;
+        for (uint32_t i = 0, w = width, h = height; i < numLevels; ++i, w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+        {
+            valueCount += static_cast<size_t>(w) * h;
+        }
+
+        auto layout = image.getLayout();
+        layout.maxNumMipmaps = static_cast<uint8_t>(numLevels);
+
+        auto values = new V[valueCount];
+        generateLevels(static_cast<const T*>(image.dataPointer()), width, height, components, srgbFormat, numLevels, settings, reinterpret_cast<T*>(values));
+        return vsg::Array2D<V>::create(width, height, values, layout);
+    }
+} // namespace
+
+vsg::ref_ptr<vsg::Data> vsgXchange::generateMipmaps(const vsg::Data& image, const MipmapSettings& settings)
+{
+    auto layout = image.getLayout();
+    if (layout.maxNumMipmaps > 1 || image.depth() > 1 || (image.width() <= 1 && image.height() <= 1)) return {};
+    if (layout.stride != 0 && layout.stride != image.valueSize()) return {};
+
+    switch (layout.format)
+    {
+    case VK_FORMAT_R8_UNORM: return createMipmappedImage<uint8_t, uint8_t>(image, 1, false, settings);
+    case VK_FORMAT_R8_SRGB: return createMipmappedImage<uint8_t, uint8_t>(image, 1, true, settings);
+    case VK_FORMAT_R8G8_UNORM: return createMipmappedImage<vsg::ubvec2, uint8_t>(image, 2, false, settings);
+    case VK_FORMAT_R8G8_SRGB: return createMipmappedImage<vsg::ubvec2, uint8_t>(image, 2, true, settings);
+    case VK_FORMAT_R8G8B8_UNORM:
+    case VK_FORMAT_B8G8R8_UNORM: return createMipmappedImage<vsg::ubvec3, uint8_t>(image, 3, false, settings);
+    case VK_FORMAT_R8G8B8_SRGB:
+    case VK_FORMAT_B8G8R8_SRGB: return createMipmappedImage<vsg::ubvec3, uint8_t>(image, 3, true, settings);
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_UNORM: return createMipmappedImage<vsg::ubvec4, uint8_t>(image, 4, false, settings);
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_SRGB: return createMipmappedImage<vsg::ubvec4, uint8_t>(image, 4, true, settings);
+    case VK_FORMAT_R16_UNORM: return createMipmappedImage<uint16_t, uint16_t>(image, 1, false, settings);
+    case VK_FORMAT_R16G16_UNORM: return createMipmappedImage<vsg::usvec2, uint16_t>(image, 2, false, settings);
+    case VK_FORMAT_R16G16B16_UNORM: return createMipmappedImage<vsg::usvec3, uint16_t>(image, 3, false, settings);
+    case VK_FORMAT_R16G16B16A16_UNORM: return createMipmappedImage<vsg::usvec4, uint16_t>(image, 4, false, settings);
+    case VK_FORMAT_R32_SFLOAT: return createMipmappedImage<float, float>(image, 1, false, settings);
+    case VK_FORMAT_R32G32_SFLOAT: return createMipmappedImage<vsg::vec2, float>(image, 2, false, settings);
+    case VK_FORMAT_R32G32B32_SFLOAT: return createMipmappedImage<vsg::vec3, float>(image, 3, false, settings);
+    case VK_FORMAT_R32G32B32A32_SFLOAT: return createMipmappedImage<vsg::vec4, float>(image, 4, false, settings);
+    default: return {};
+    }
+}
+
+vsg::ref_ptr<vsg::Data> vsgXchange::generateMipmaps(vsg::ref_ptr<vsg::Data> image, const vsg::Options* options)
+{
+    bool generate = false;
+    if (!image || !options || !options->getValue(images::generate_mipmaps, generate) || !generate) return image;
+
+    MipmapSettings settings;
+    std::string filter;
+    if (options->getValue(images::mipmap_filter, filter))
+    {
+        if (filter == "kaiser")
+            settings.filter = MipmapSettings::KAISER;
+        else if (filter != "box")
+            std::cout << "Warning: unsupported mipmap_filter \"" << filter << "\", using box filter." << std::endl;
+    }
+    options->getValue(images::mipmap_srgb, settings.srgb);
+    options->getValue(images::mipmap_threads, settings.maxThreads);
+
+    if (auto mipmapped = generateMipmaps(*image, settings)) return mipmapped;
+    return image;
+}
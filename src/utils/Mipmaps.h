@@ -0,0 +1,45 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+
+namespace vsgXchange
+{
+
+    /// settings controlling the mipmaps computed by generateMipmaps().
+    struct MipmapSettings
+    {
+        enum Filter
+        {
+            BOX,   /// average of the texels each mipmap texel covers, fast and free of ringing
+            KAISER /// Kaiser windowed sinc, sharper mipmaps at the cost of more taps per texel
+        };
+
+        Filter filter = BOX;
+
+        /// filter 8 bit UNORM colour components in linear space, treating them as sRGB encoded. _SRGB formats are always filtered in linear space.
+        bool srgb = false;
+
+        /// maximum number of threads to filter each mipmap level with, 0 selects std::thread::hardware_concurrency().
+        uint32_t maxThreads = 0;
+    };
+
+    /// return a copy of a 2D image with a complete mipmap chain packed after the base level, as the vsg::Data layout expects when maxNumMipmaps > 1.
+    /// Supports the 8 bit UNORM/SRGB, 16 bit UNORM and 32 bit SFLOAT R to RGBA and BGRA formats, returns null for other formats or images that already have mipmaps.
+    vsg::ref_ptr<vsg::Data> generateMipmaps(const vsg::Data& image, const MipmapSettings& settings);
+
+    /// generate mipmaps for image when the images::generate_mipmaps option is set, returning image unchanged otherwise or when its format isn't supported.
+    vsg::ref_ptr<vsg::Data> generateMipmaps(vsg::ref_ptr<vsg::Data> image, const vsg::Options* options);
+
+} // namespace vsgXchange
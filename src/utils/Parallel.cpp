@@ -0,0 +1,52 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace vsgXchange;
+
+void vsgXchange::parallelFor(uint32_t count, uint32_t maxThreads, const std::function<void(uint32_t)>& function)
+{
+    uint32_t numThreads = maxThreads != 0 ? maxThreads : std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads, count);
+
+    if (numThreads <= 1)
+    {
+        for (uint32_t i = 0; i < count; ++i) function(i);
+        return;
+    }
+
+    // each operation takes the next index, so the threads stay busy regardless of how long each call takes.
+    std::atomic<uint32_t> numTaken{0};
+    auto run = [&]() {
+        for (uint32_t i = numTaken++; i < count; i = numTaken++) function(i);
+    };
+
+    auto status = vsg::ActivityStatus::create();
+    auto operationThreads = vsg::OperationThreads::create(numThreads, status);
+    auto latch = vsg::Latch::create(numThreads);
+
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        operationThreads->queue->add(FunctionOperation::create(run, latch));
+    }
+
+    // wait until all the calls have completed
+    latch->wait();
+
+    // signal that we are finished and the threads should close
+    status->set(false);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/threading/Latch.h>
+#include <vsg/threading/OperationThreads.h>
+
+#include <functional>
+
+namespace vsgXchange
+{
+
+    /// run a function on an OperationThreads thread, counting down the latch once complete.
+    struct FunctionOperation : public vsg::Inherit<vsg::Operation, FunctionOperation>
+    {
+        FunctionOperation(std::function<void()> in_function, vsg::ref_ptr<vsg::Latch> in_latch) :
+            function(in_function),
+            latch(in_latch) {}
+
+        std::function<void()> function;
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        void run() override
+        {
+            function();
+            latch->count_down();
+        }
+    };
+
+    /// call function(i) for each i in [0, count), spread across up to maxThreads threads, 0 selects std::thread::hardware_concurrency().
+    /// Runs on the calling thread when only one thread would be used.
+    void parallelFor(uint32_t count, uint32_t maxThreads, const std::function<void(uint32_t)>& function);
+
+} // namespace vsgXchange
@@ -0,0 +1,215 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "PixelConversion.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define PIXEL_CONVERSION_SSSE3
+#    include <tmmintrin.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define SSSE3_FUNCTION
+#    else
+#        define SSSE3_FUNCTION __attribute__((target("ssse3")))
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#    define PIXEL_CONVERSION_NEON
+#    include <arm_neon.h>
+#endif
+
+using namespace vsgXchange;
+
+namespace
+{
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // scalar implementations, used for the pixels left over by the SIMD implementations and when SIMD isn't available
+    //
+    void convertRGBtoRGBA_scalar(const uint8_t* src, uint8_t* dst, size_t numPixels, bool swapRedBlue)
+    {
+        const size_t r = swapRedBlue ? 2 : 0;
+        const size_t b = swapRedBlue ? 0 : 2;
+        for (size_t i = 0; i < numPixels; ++i, src += 3, dst += 4)
+        {
+            dst[0] = src[r];
+            dst[1] = src[1];
+            dst[2] = src[b];
+            dst[3] = 255;
+        }
+    }
+
+    void swapRedBlue_scalar(const uint8_t* src, uint8_t* dst, size_t numPixels, uint32_t numComponents)
+    {
+        for (size_t i = 0; i < numPixels; ++i, src += numComponents, dst += numComponents)
+        {
+            uint8_t red = src[2];
+            uint8_t blue = src[0];
+            dst[0] = red;
+            dst[1] = src[1];
+            dst[2] = blue;
+            if (numComponents == 4) dst[3] = src[3];
+        }
+    }
+
+#if defined(PIXEL_CONVERSION_SSSE3)
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // SSSE3 implementations, selected at runtime so the library doesn't need to be built with SSSE3 enabled
+    //
+    bool hasSSSE3()
+    {
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+#    else
+        return __builtin_cpu_supports("ssse3");
+#    endif
+    }
+
+    bool useSSSE3()
+    {
+        static const bool s_useSSSE3 = hasSSSE3();
+        return s_useSSSE3;
+    }
+
+    // returns the number of pixels converted, processing 16 pixels at a time.
+    SSSE3_FUNCTION size_t convertRGBtoRGBA_SSSE3(const uint8_t* src, uint8_t* dst, size_t numPixels, bool swapRedBlue)
+    {
+        const __m128i shuffle = swapRedBlue ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                            : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+        size_t i = 0;
+        for (; i + 16 <= numPixels; i += 16, src += 48, dst += 64)
+        {
+            __m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            __m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+
+            // gather the 12 bytes of each group of 4 pixels into the low bytes of a register before expanding them.
+            __m128i out0 = _mm_or_si128(_mm_shuffle_epi8(in0, shuffle), alpha);
+            __m128i out1 = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), shuffle), alpha);
+            __m128i out2 = _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), shuffle), alpha);
+            __m128i out3 = _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(in2, 4), shuffle), alpha);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), out0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), out1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), out2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), out3);
+        }
+        return i;
+    }
+
+    SSSE3_FUNCTION size_t swapRedBlue_SSSE3(const uint8_t* src, uint8_t* dst, size_t numPixels, uint32_t numComponents)
+    {
+        size_t i = 0;
+        if (numComponents == 4)
+        {
+            const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+            for (; i + 4 <= numPixels; i += 4, src += 16, dst += 16)
+            {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(pixels, shuffle));
+            }
+        }
+        else
+        {
+            // swap 4 pixels per 16 byte load, passing the trailing 4 bytes through unchanged as they are rewritten by the next iteration.
+            const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+            for (; i + 6 <= numPixels; i += 4, src += 12, dst += 12)
+            {
+                __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_shuffle_epi8(pixels, shuffle));
+            }
+        }
+        return i;
+    }
+#endif
+
+#if defined(PIXEL_CONVERSION_NEON)
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // NEON implementations, NEON is always available on ARM64
+    //
+    size_t convertRGBtoRGBA_NEON(const uint8_t* src, uint8_t* dst, size_t numPixels, bool swapRedBlue)
+    {
+        const uint8x16_t alpha = vdupq_n_u8(255);
+
+        size_t i = 0;
+        for (; i + 16 <= numPixels; i += 16, src += 48, dst += 64)
+        {
+            uint8x16x3_t in = vld3q_u8(src);
+            uint8x16x4_t out;
+            out.val[0] = swapRedBlue ? in.val[2] : in.val[0];
+            out.val[1] = in.val[1];
+            out.val[2] = swapRedBlue ? in.val[0] : in.val[2];
+            out.val[3] = alpha;
+            vst4q_u8(dst, out);
+        }
+        return i;
+    }
+
+    size_t swapRedBlue_NEON(const uint8_t* src, uint8_t* dst, size_t numPixels, uint32_t numComponents)
+    {
+        size_t i = 0;
+        if (numComponents == 4)
+        {
+            for (; i + 16 <= numPixels; i += 16, src += 64, dst += 64)
+            {
+                uint8x16x4_t pixels = vld4q_u8(src);
+                uint8x16_t red = pixels.val[2];
+                pixels.val[2] = pixels.val[0];
+                pixels.val[0] = red;
+                vst4q_u8(dst, pixels);
+            }
+        }
+        else
+        {
+            for (; i + 16 <= numPixels; i += 16, src += 48, dst += 48)
+            {
+                uint8x16x3_t pixels = vld3q_u8(src);
+                uint8x16_t red = pixels.val[2];
+                pixels.val[2] = pixels.val[0];
+                pixels.val[0] = red;
+                vst3q_u8(dst, pixels);
+            }
+        }
+        return i;
+    }
+#endif
+
+} // namespace
+
+void vsgXchange::convertRGBtoRGBA(const uint8_t* src, uint8_t* dst, size_t numPixels, bool swapRedBlue)
+{
+    size_t i = 0;
+#if defined(PIXEL_CONVERSION_SSSE3)
+    if (useSSSE3()) i = convertRGBtoRGBA_SSSE3(src, dst, numPixels, swapRedBlue);
+#elif defined(PIXEL_CONVERSION_NEON)
+    i = convertRGBtoRGBA_NEON(src, dst, numPixels, swapRedBlue);
+#endif
+    convertRGBtoRGBA_scalar(src + i * 3, dst + i * 4, numPixels - i, swapRedBlue);
+}
+
+void vsgXchange::swapRedBlue(const uint8_t* src, uint8_t* dst, size_t numPixels, uint32_t numComponents)
+{
+    if (numComponents != 3 && numComponents != 4) return;
+
+    size_t i = 0;
+#if defined(PIXEL_CONVERSION_SSSE3)
+    if (useSSSE3()) i = swapRedBlue_SSSE3(src, dst, numPixels, numComponents);
+#elif defined(PIXEL_CONVERSION_NEON)
+    i = swapRedBlue_NEON(src, dst, numPixels, numComponents);
+#endif
+    swapRedBlue_scalar(src + i * numComponents, dst + i * numComponents, numPixels - i, numComponents);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vsgXchange
+{
+
+    /// Pixel format conversions of 8 bit per component images, shared by the image readers.
+    /// Uses SSSE3 when the CPU supports it, or NEON on ARM64, otherwise falls back to scalar code.
+
+    /// copy RGB pixels to RGBA with alpha set to 255, swapRedBlue converts BGR to RGBA. src and dst must not overlap.
+    void convertRGBtoRGBA(const uint8_t* src, uint8_t* dst, size_t numPixels, bool swapRedBlue = false);
+
+    /// swap the red and blue components of RGB/BGR or RGBA/BGRA pixels, numComponents must be 3 or 4. src and dst may be the same.
+    void swapRedBlue(const uint8_t* src, uint8_t* dst, size_t numPixels, uint32_t numComponents);
+
+} // namespace vsgXchange
@@ -0,0 +1,86 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "Signature.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+using namespace vsgXchange;
+
+vsg::Path vsgXchange::extensionFromSignature(const uint8_t* data, size_t size)
+{
+    auto startsWith = [&](const char* signature, size_t length) {
+        return size >= length && std::memcmp(data, signature, length) == 0;
+    };
+
+    if (startsWith("\x89PNG\r\n\x1a\n", 8)) return ".png";
+    if (startsWith("\xff\xd8\xff", 3)) return ".jpg";
+    if (startsWith("GIF87a", 6) || startsWith("GIF89a", 6)) return ".gif";
+    if (startsWith("#?RADIANCE", 10) || startsWith("#?RGBE", 6)) return ".hdr";
+    if (startsWith("DDS ", 4)) return ".dds";
+    if (startsWith("\xabKTX 11\xbb\r\n\x1a\n", 12)) return ".ktx";
+    if (startsWith("\xabKTX 20\xbb\r\n\x1a\n", 12)) return ".ktx2";
+    if (startsWith("glTF", 4)) return ".glb";
+
+    // glTF JSON has no signature, so look for a JSON object that has the top level "asset" property required by the glTF spec.
+    size_t pos = 0;
+    if (size >= 3 && startsWith("\xef\xbb\xbf", 3)) pos = 3;
+    while (pos < size && std::isspace(data[pos])) ++pos;
+    if (pos < size && data[pos] == '{')
+    {
+        const char* asset = "\"asset\"";
+        size_t length = std::strlen(asset);
+        for (size_t i = pos; i + length <= size; ++i)
+        {
+            if (std::memcmp(data + i, asset, length) == 0) return ".gltf";
+        }
+    }
+
+    return {};
+}
+
+vsg::ref_ptr<const vsg::Options> vsgXchange::optionsWithSignatureHint(const uint8_t* data, size_t size, vsg::ref_ptr<const vsg::Options> options)
+{
+    auto ext = extensionFromSignature(data, std::min(size, signatureProbeSize));
+    if (ext.empty()) return options;
+
+    if (options && !options->extensionHint.empty())
+    {
+        // only an image signature is definitive enough to override the caller's hint, a glTF JSON match may well be some other JSON based format.
+        bool imageSignature = (ext == ".png" || ext == ".jpg" || ext == ".gif" || ext == ".hdr" || ext == ".dds" || ext == ".ktx" || ext == ".ktx2");
+        if (!imageSignature || options->extensionHint == ext) return options;
+
+        // .jpeg and .jpe hints already identify JPEG data
+        if (ext == ".jpg" && (options->extensionHint == ".jpeg" || options->extensionHint == ".jpe")) return options;
+    }
+
+    auto local_options = options ? vsg::Options::create(*options) : vsg::Options::create();
+    local_options->extensionHint = ext;
+    return local_options;
+}
+
+vsg::ref_ptr<const vsg::Options> vsgXchange::optionsWithSignatureHint(std::istream& fin, vsg::ref_ptr<const vsg::Options> options)
+{
+    auto start = fin.tellg();
+    if (start == std::streampos(-1)) return options;
+
+    uint8_t probe[signatureProbeSize];
+    fin.read(reinterpret_cast<char*>(probe), signatureProbeSize);
+    auto size = static_cast<size_t>(fin.gcount());
+
+    fin.clear();
+    fin.seekg(start);
+
+    return optionsWithSignatureHint(probe, size, options);
+}
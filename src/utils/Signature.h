@@ -0,0 +1,38 @@
+#pragma once
+
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/io/Options.h>
+
+#include <cstdint>
+#include <istream>
+
+namespace vsgXchange
+{
+
+    /// return the file extension associated with the format signature at the start of data, i.e. ".png" for data starting with the PNG signature.
+    /// Recognizes PNG, JPEG, GIF, Radiance HDR, DDS, KTX, KTX2, glTF and GLB, returning an empty extension if the format isn't recognized.
+    vsg::Path extensionFromSignature(const uint8_t* data, size_t size);
+
+    /// number of leading bytes that extensionFromSignature() uses to identify a format.
+    constexpr size_t signatureProbeSize = 512;
+
+    /// return options with the extensionHint set from the format signature, so that composite ReaderWriters can route data
+    /// from sources with missing or misleading file extensions. An extensionHint set by the caller is only replaced when it
+    /// contradicts an image signature, otherwise the original options are returned.
+    vsg::ref_ptr<const vsg::Options> optionsWithSignatureHint(const uint8_t* data, size_t size, vsg::ref_ptr<const vsg::Options> options);
+
+    /// peek at the start of a seekable stream to set the extensionHint, the stream position is restored afterwards.
+    vsg::ref_ptr<const vsg::Options> optionsWithSignatureHint(std::istream& fin, vsg::ref_ptr<const vsg::Options> options);
+
+} // namespace vsgXchange
@@ -0,0 +1,89 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include <vsgXchange/freetype.h>
+
+#include <iomanip>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    freetype_packing [-t numThreads] [--char-ranges ranges] font_file [font_file ...]" << std::endl;
+        std::cout << "Reads each font with the shelf, skyline and maxrects packers, reporting the atlas size, area utilisation and packing time of each." << std::endl;
+        return 1;
+    }
+
+    auto numThreads = arguments.value(0u, "-t");
+    auto char_ranges = arguments.value(std::string(), "--char-ranges");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    const std::vector<std::string> packings{"shelf", "skyline", "maxrects"};
+
+    struct Totals
+    {
+        double atlasArea = 0.0;
+        double glyphArea = 0.0;
+        double packingTime = 0.0;
+    };
+    std::vector<Totals> totals(packings.size());
+
+    auto freetype = vsgXchange::freetype::create();
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    int result = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::cout << arguments[i] << std::endl;
+        for (size_t p = 0; p < packings.size(); ++p)
+        {
+            auto options = vsg::Options::create();
+            options->setValue(vsgXchange::freetype::packing, packings[p]);
+            options->setValue(vsgXchange::freetype::collect_stats, true);
+            options->setValue(vsgXchange::freetype::max_threads, numThreads);
+            if (!char_ranges.empty()) options->setValue(vsgXchange::freetype::char_ranges, char_ranges);
+
+            auto font = freetype->read(arguments[i], options).cast<vsg::Font>();
+            auto stats = font ? font->getObject<vsgXchange::FontStats>("stats") : nullptr;
+            if (!stats)
+            {
+                std::cerr << "Error: unable to read font file " << arguments[i] << std::endl;
+                result = 1;
+                break;
+            }
+
+            double atlasArea = double(font->atlas->width()) * double(font->atlas->height());
+            totals[p].atlasArea += atlasArea;
+            totals[p].glyphArea += atlasArea * stats->packingEfficiency;
+            totals[p].packingTime += stats->packingTime;
+
+            std::cout << "    " << std::setw(8) << packings[p] << " : " << stats->numGlyphs << " glyphs, atlas " << font->atlas->width() << " x " << font->atlas->height()
+                      << ", utilisation " << stats->packingEfficiency << ", packing " << stats->packingTime * 1000.0 << "ms" << std::endl;
+        }
+    }
+
+    std::cout << "all fonts" << std::endl;
+    for (size_t p = 0; p < packings.size(); ++p)
+    {
+        std::cout << "    " << std::setw(8) << packings[p] << " : atlas area " << totals[p].atlasArea / totals[0].atlasArea << " of shelf, utilisation "
+                  << totals[p].glyphArea / totals[p].atlasArea << ", packing " << totals[p].packingTime * 1000.0 << "ms" << std::endl;
+    }
+
+    return result;
+}
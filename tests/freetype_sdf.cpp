@@ -0,0 +1,236 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+// compiled together with the freetype ReaderWriter's source so that the glyph regions can be computed directly.
+#include "freetype.cpp"
+
+#include <chrono>
+#include <iostream>
+
+namespace freetype_sdf
+{
+    // freetype::Implementation is only accessible to the freetype ReaderWriter and classes derived from it.
+    struct Access : public vsgXchange::freetype
+    {
+        using Generator = freetype::Implementation;
+    };
+
+    using Generator = Access::Generator;
+
+    /// distance to the nearest edge found by visiting every edge of every contour, as computed before the EdgeGrid was introduced.
+    float nearest_contour_edge(const Generator::Contours& contours, const vsg::vec2& v)
+    {
+        float min_distance = std::numeric_limits<float>::max();
+        for (auto& contour : contours)
+        {
+            auto& points = contour.points;
+            auto& edges = contour.edges;
+            for (size_t i = 0; i < edges.size(); ++i)
+            {
+                auto& p0 = points[i];
+                auto& edge = edges[i];
+
+                vsg::vec2 v_p0 = v - p0;
+                float dot_v_p0 = v_p0.x * edge.x + v_p0.y * edge.y;
+
+                if (dot_v_p0 < 0.0f)
+                {
+                    float distance = vsg::length2(v - p0);
+                    if (distance < min_distance) min_distance = distance;
+                }
+                else if (dot_v_p0 <= edge.z)
+                {
+                    float d = v_p0.y * edge.x - v_p0.x * edge.y;
+                    float distance = d * d;
+                    if (distance < min_distance) min_distance = distance;
+                }
+            }
+        }
+        return sqrt(min_distance);
+    }
+
+    /// per texel inside/outside test counting the contour crossings to the left of v, as computed before the scanline pass was introduced.
+    bool outside_contours(const Generator::Contours& contours, const vsg::vec2& v)
+    {
+        uint32_t numLeft = 0;
+        for (auto& contour : contours)
+        {
+            auto& points = contour.points;
+            for (size_t i = 0; i < points.size() - 1; ++i)
+            {
+                auto& p0 = points[i];
+                auto& p1 = points[i + 1];
+
+                if (p0 == v || p1 == v) return false;
+
+                if (p0.y == p1.y)
+                {
+                    if (p0.y == v.y && vsgXchange::between(p0.x, v.x, p1.x)) return false;
+                }
+                else if (p0.x == p1.x)
+                {
+                    if (vsgXchange::between2(p0.y, v.y, p1.y))
+                    {
+                        if (v.x == p0.x)
+                            return false;
+                        else if (p0.x < v.x)
+                            ++numLeft;
+                    }
+                }
+                else if (vsgXchange::between2(p0.y, v.y, p1.y))
+                {
+                    if (v.x > p0.x && v.x > p1.x)
+                    {
+                        ++numLeft;
+                    }
+                    else if (vsgXchange::between(p0.x, v.x, p1.x))
+                    {
+                        float r = (v.y - p0.y) / (p1.y - p0.y);
+                        if ((p0.x + (p1.x - p0.x) * r) < v.x) ++numLeft;
+                    }
+                }
+            }
+        }
+        return (numLeft % 2) == 0;
+    }
+
+    /// brute force equivalent of Generator::computeGlyphRegion for outline glyphs.
+    void computeReferenceRegion(Generator::Atlas& atlas, const Generator::AtlasSettings& settings, const Generator::GlyphRegion& region)
+    {
+        float scale = 2.0f / float(settings.pixel_size);
+        int delta = settings.quad_margin - 2;
+
+        for (int r = -delta; r < static_cast<int>(region.height + delta); ++r)
+        {
+            std::size_t index = atlas.index(region.xpos - delta, region.ypos + r);
+            for (int c = -delta; c < static_cast<int>(region.width + delta); ++c)
+            {
+                vsg::vec2 v(static_cast<float>(c), static_cast<float>(r));
+
+                auto min_distance = nearest_contour_edge(region.contours, v);
+                if (!region.extents.contains(v) || outside_contours(region.contours, v)) min_distance = -min_distance;
+
+                float value = Generator::mid_value + min_distance * scale * (Generator::max_value - Generator::min_value);
+                atlas.at(index++) = static_cast<Generator::sdf_type>(std::clamp(value, Generator::min_value, Generator::max_value));
+            }
+        }
+    }
+
+} // namespace freetype_sdf
+
+int main(int argc, char** argv)
+{
+    using namespace freetype_sdf;
+    using clock = std::chrono::steady_clock;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    freetype_sdf [--pixel-size 48] [--tolerance 1] font_file [font_file ...]" << std::endl;
+        std::cout << "Compares the edge grid accelerated outline distance fields against a brute force search of all the contour edges, reporting glyphs/second for both." << std::endl;
+        return 1;
+    }
+
+    auto pixel_size = arguments.value(48u, "--pixel-size");
+    auto tolerance = arguments.value(1, "--tolerance");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    FT_Library library;
+    if (FT_Init_FreeType(&library))
+    {
+        std::cerr << "Error: unable to initialize FreeType." << std::endl;
+        return 1;
+    }
+
+    Generator generator;
+
+    Generator::AtlasSettings settings;
+    settings.pixel_size = pixel_size;
+    settings.freetype_pixel_size_scale = 1.0f / 64.0f;
+    settings.texel_margin = std::max(settings.pixel_size / 4, 8u);
+    settings.quad_margin = settings.texel_margin / 2;
+
+    int result = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        FT_Face face;
+        if (FT_New_Face(library, arguments[i], 0, &face))
+        {
+            std::cerr << "Error: unable to read font file " << arguments[i] << std::endl;
+            result = 1;
+            continue;
+        }
+
+        FT_Set_Pixel_Sizes(face, pixel_size, pixel_size);
+
+        std::vector<Generator::GlyphRegion> regions;
+        FT_UInt glyph_index;
+        for (FT_ULong charcode = FT_Get_First_Char(face, &glyph_index); glyph_index != 0; charcode = FT_Get_Next_Char(face, charcode, &glyph_index))
+        {
+            Generator::GlyphRegion region;
+            vsg::GlyphMetrics metrics;
+            if (generator.loadGlyph(face, glyph_index, settings, region, metrics) && region.useOutline && !region.contours.empty())
+            {
+                region.xpos = settings.texel_margin;
+                region.ypos = settings.texel_margin;
+                regions.push_back(std::move(region));
+            }
+        }
+
+        FT_Done_Face(face);
+
+        double gridTime = 0.0;
+        double referenceTime = 0.0;
+        size_t numTexels = 0;
+        size_t numMismatched = 0;
+        int maxDifference = 0;
+
+        for (auto& region : regions)
+        {
+            auto width = region.width + 2 * settings.texel_margin;
+            auto height = region.height + 2 * settings.texel_margin;
+            auto atlas = Generator::Atlas::create(width, height);
+            auto reference = Generator::Atlas::create(width, height);
+            std::fill(atlas->begin(), atlas->end(), static_cast<Generator::sdf_type>(Generator::min_value));
+            std::fill(reference->begin(), reference->end(), static_cast<Generator::sdf_type>(Generator::min_value));
+
+            auto start = clock::now();
+            numTexels += generator.computeGlyphRegion(*atlas, settings, region);
+            auto middle = clock::now();
+            computeReferenceRegion(*reference, settings, region);
+            auto end = clock::now();
+
+            gridTime += std::chrono::duration<double>(middle - start).count();
+            referenceTime += std::chrono::duration<double>(end - middle).count();
+
+            for (size_t t = 0; t < atlas->size(); ++t)
+            {
+                int difference = std::abs(int(atlas->at(t)) - int(reference->at(t)));
+                maxDifference = std::max(maxDifference, difference);
+                if (difference > tolerance) ++numMismatched;
+            }
+        }
+
+        std::cout << arguments[i] << " : " << regions.size() << " glyphs, " << numTexels << " texels" << std::endl;
+        std::cout << "    edge grid   : " << gridTime << "s, " << double(regions.size()) / gridTime << " glyphs/s" << std::endl;
+        std::cout << "    brute force : " << referenceTime << "s, " << double(regions.size()) / referenceTime << " glyphs/s" << std::endl;
+        std::cout << "    speedup " << referenceTime / gridTime << ", max difference " << maxDifference << ", texels beyond tolerance " << numMismatched << std::endl;
+
+        if (numMismatched > 0) result = 1;
+    }
+
+    FT_Done_FreeType(library);
+
+    return result;
+}
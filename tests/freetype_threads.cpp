@@ -0,0 +1,108 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include <vsgXchange/freetype.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace freetype_threads
+{
+    bool equal(const vsg::Data* lhs, const vsg::Data* rhs)
+    {
+        if (!lhs || !rhs) return lhs == rhs;
+        return lhs->dataSize() == rhs->dataSize() && std::memcmp(lhs->dataPointer(), rhs->dataPointer(), lhs->dataSize()) == 0;
+    }
+
+    bool equal(const vsg::Font* lhs, const vsg::Font* rhs)
+    {
+        if (!lhs || !rhs) return false;
+        return lhs->ascender == rhs->ascender && lhs->descender == rhs->descender && lhs->height == rhs->height &&
+               equal(lhs->atlas.get(), rhs->atlas.get()) &&
+               equal(lhs->glyphMetrics.get(), rhs->glyphMetrics.get()) &&
+               equal(lhs->charmap.get(), rhs->charmap.get());
+    }
+} // namespace freetype_threads
+
+int main(int argc, char** argv)
+{
+    using namespace freetype_threads;
+    using clock = std::chrono::steady_clock;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    freetype_threads [-t numThreads] [--char-ranges ranges] font_file [font_file ...]" << std::endl;
+        std::cout << "Reads the fonts one after another, then again from numThreads threads sharing one freetype ReaderWriter, checking the concurrently read fonts are byte-identical." << std::endl;
+        return 1;
+    }
+
+    auto numThreads = arguments.value(0u, "-t");
+    auto char_ranges = arguments.value(std::string(), "--char-ranges");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<vsg::Path> filenames;
+    for (int i = 1; i < argc; ++i) filenames.push_back(arguments[i]);
+
+    if (numThreads == 0) numThreads = static_cast<uint32_t>(filenames.size());
+
+    // glyph regions are computed on the reading thread so that the only concurrency is between the reads.
+    auto options = vsg::Options::create();
+    options->setValue(vsgXchange::freetype::max_threads, 1u);
+    if (!char_ranges.empty()) options->setValue(vsgXchange::freetype::char_ranges, char_ranges);
+
+    std::vector<vsg::ref_ptr<vsg::Font>> references;
+    auto start = clock::now();
+    for (auto& filename : filenames)
+    {
+        auto font = vsgXchange::freetype::create()->read(filename, options).cast<vsg::Font>();
+        if (!font)
+        {
+            std::cerr << "Error: unable to read font file " << filename << std::endl;
+            return 1;
+        }
+        references.push_back(font);
+    }
+    double serialTime = std::chrono::duration<double>(clock::now() - start).count();
+
+    auto freetype = vsgXchange::freetype::create();
+    std::atomic<uint32_t> numMismatched{0};
+    std::vector<std::thread> threads;
+
+    start = clock::now();
+    for (uint32_t t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            size_t index = t % filenames.size();
+            auto font = freetype->read(filenames[index], options).cast<vsg::Font>();
+            if (!equal(font.get(), references[index].get()))
+            {
+                std::cerr << "Error: thread " << t << " read of " << filenames[index] << " differs from the serial read." << std::endl;
+                ++numMismatched;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double concurrentTime = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::cout << filenames.size() << " fonts read serially in " << serialTime << "s" << std::endl;
+    std::cout << numThreads << " reads from " << numThreads << " threads in " << concurrentTime << "s, " << numMismatched << " differed from the serial reads" << std::endl;
+
+    return numMismatched > 0 ? 1 : 0;
+}
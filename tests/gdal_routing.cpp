@@ -0,0 +1,167 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include <vsgXchange/all.h>
+
+#include <vsgGIS/gdal_utils.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+namespace gdal_routing
+{
+    /// ReaderWriter that reads everything but the VSG and OSG native formats with GDAL, as the GDAL ReaderWriter did before plain textures were routed to stbi, dds and ktx.
+    class UnroutedGDAL : public vsg::Inherit<vsg::ReaderWriter, UnroutedGDAL>
+    {
+    public:
+        UnroutedGDAL()
+        {
+            vsgGIS::init();
+        }
+
+        vsg::ref_ptr<vsg::Object> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const override
+        {
+            static const std::set<vsg::Path> nativeFormats{".vsgb", ".vsgt", ".osgb", ".osgt", ".osg"};
+            if (nativeFormats.count(vsg::lowerCaseFileExtension(filename)) != 0) return {};
+
+            vsg::Path filenameToUse = vsg::findFile(filename, options);
+            if (filenameToUse.empty()) return {};
+
+            vsgGIS::initGDAL();
+
+            auto dataset = vsgGIS::openSharedDataSet(filenameToUse.c_str(), GA_ReadOnly);
+            if (!dataset) return {};
+
+            auto types = vsgGIS::dataTypes(*dataset);
+            if (types.size() != 1) return {};
+
+            std::vector<GDALRasterBand*> rasterBands;
+            for (int i = 1; i <= dataset->GetRasterCount(); ++i)
+            {
+                GDALRasterBand* band = dataset->GetRasterBand(i);
+                if (band->GetColorInterpretation() != GCI_Undefined) rasterBands.push_back(band);
+            }
+
+            int numComponents = static_cast<int>(rasterBands.size());
+            if (numComponents == 0) return {};
+
+            bool mapRGBtoRGBAHint = !options || options->mapRGBtoRGBAHint;
+            if (mapRGBtoRGBAHint && numComponents == 3) numComponents = 4;
+            if (numComponents > 4) return {};
+
+            auto image = vsgGIS::createImage2D(dataset->GetRasterXSize(), dataset->GetRasterYSize(), numComponents, *types.begin(), vsg::dvec4(0.0, 0.0, 0.0, 1.0));
+            if (!image) return {};
+
+            for (int component = 0; component < static_cast<int>(rasterBands.size()); ++component)
+            {
+                vsgGIS::copyRasterBandToImage(*rasterBands[component], *image, component);
+            }
+
+            vsgGIS::assignMetaData(*dataset, *image);
+
+            ++numRead;
+            return image;
+        }
+
+        mutable std::atomic<uint32_t> numRead{0};
+    };
+
+    struct Timing
+    {
+        size_t numRead = 0;
+        double time = 0.0;
+    };
+
+    Timing readAll(const std::vector<vsg::Path>& filenames, vsg::ref_ptr<const vsg::Options> options)
+    {
+        using clock = std::chrono::steady_clock;
+
+        Timing timing;
+        auto start = clock::now();
+        for (auto& filename : filenames)
+        {
+            if (vsg::read(filename, options)) ++timing.numRead;
+        }
+        timing.time = std::chrono::duration<double>(clock::now() - start).count();
+        return timing;
+    }
+
+} // namespace gdal_routing
+
+int main(int argc, char** argv)
+{
+    using namespace gdal_routing;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    gdal_routing [--model model_file] [directory ...]" << std::endl;
+        std::cout << "Loads the models and all the images in the directories with the GDAL ReaderWriter leaving plain textures to stbi, dds and ktx," << std::endl;
+        std::cout << "then again with GDAL decoding every texture as it did before, reporting the load times of both." << std::endl;
+        return 1;
+    }
+
+    std::vector<vsg::Path> models;
+    vsg::Path model;
+    while (arguments.read("--model", model)) models.push_back(model);
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<vsg::Path> textures;
+    for (int i = 1; i < argc; ++i)
+    {
+        for (auto& entry : std::filesystem::recursive_directory_iterator(arguments[i]))
+        {
+            if (entry.is_regular_file()) textures.push_back(entry.path().string());
+        }
+    }
+
+    auto routed = vsg::Options::create(vsgXchange::all::create());
+
+    auto unroutedGDAL = UnroutedGDAL::create();
+    auto unrouted = vsg::Options::create(unroutedGDAL);
+    unrouted->add(vsgXchange::all::create());
+
+    // register GDAL's drivers and warm the page cache so that neither pass pays for them.
+    vsgGIS::initGDAL();
+    readAll(models, routed);
+    readAll(textures, routed);
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    int result = 0;
+    for (auto& [name, filenames] : {std::make_pair("models", &models), std::make_pair("textures", &textures)})
+    {
+        if (filenames->empty()) continue;
+
+        unroutedGDAL->numRead = 0;
+        auto before = readAll(*filenames, unrouted);
+        uint32_t numReadByGDAL = unroutedGDAL->numRead;
+        auto after = readAll(*filenames, routed);
+
+        std::cout << filenames->size() << " " << name << std::endl;
+        std::cout << "    GDAL decoding textures : " << before.numRead << " read in " << before.time << "s, " << numReadByGDAL << " images decoded by GDAL" << std::endl;
+        std::cout << "    routed textures        : " << after.numRead << " read in " << after.time << "s" << std::endl;
+        std::cout << "    speedup " << before.time / after.time << std::endl;
+
+        if (after.numRead < before.numRead) result = 1;
+    }
+
+    return result;
+}
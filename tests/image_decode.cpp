@@ -0,0 +1,176 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include "Decoders.h"
+
+#define STB_IMAGE_STATIC
+#define STB_IMAGE_IMPLEMENTATION
+
+#if defined(__GNUC__)
+#    pragma GCC diagnostic push
+#    pragma GCC diagnostic ignored "-Wunused-function"
+#    pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+
+#include "stb_image.h"
+
+#if defined(__GNUC__)
+#    pragma GCC diagnostic pop
+#endif
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace image_decode
+{
+    struct Totals
+    {
+        size_t numImages = 0;
+        double megaPixels = 0.0;
+        double backendTime = 0.0;
+        double stbTime = 0.0;
+        int maxDifference = 0;
+        size_t numDiffering = 0;
+    };
+
+    /// decode with the libjpeg-turbo or libspng backend, returns null if the data is left to stb_image.
+    vsg::ref_ptr<vsg::Data> readBackend(const std::vector<uint8_t>& buffer, bool mapRGBtoRGBAHint)
+    {
+        if (auto data = vsgXchange::readJPEG(buffer.data(), buffer.size(), mapRGBtoRGBAHint, 0)) return data;
+        return vsgXchange::readPNG(buffer.data(), buffer.size(), mapRGBtoRGBAHint);
+    }
+
+    /// decode with stb_image to the number of components the stbi ReaderWriter uses.
+    stbi_uc* readSTB(const std::vector<uint8_t>& buffer, bool mapRGBtoRGBAHint, int& width, int& height, int& components)
+    {
+        int length = static_cast<int>(buffer.size());
+        if (!stbi_info_from_memory(buffer.data(), length, &width, &height, &components)) return nullptr;
+        if (components == 3 && mapRGBtoRGBAHint) components = 4;
+
+        int channels;
+        return stbi_load_from_memory(buffer.data(), length, &width, &height, &channels, components);
+    }
+
+} // namespace image_decode
+
+int main(int argc, char** argv)
+{
+    using namespace image_decode;
+    using clock = std::chrono::steady_clock;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    image_decode [--iterations 10] [--rgb] file_or_directory [file_or_directory ...]" << std::endl;
+        std::cout << "Decodes the JPEG and PNG images with libjpeg-turbo and libspng, as available in this build, and with stb_image," << std::endl;
+        std::cout << "reporting the megapixels/second of both and the largest difference between their pixels. --rgb leaves RGB images as RGB rather than mapping them to RGBA." << std::endl;
+        return 1;
+    }
+
+    auto iterations = arguments.value(10u, "--iterations");
+    bool mapRGBtoRGBAHint = !arguments.read("--rgb");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<vsg::Path> filenames;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::filesystem::is_directory(arguments[i]))
+        {
+            for (auto& entry : std::filesystem::recursive_directory_iterator(arguments[i]))
+            {
+                if (entry.is_regular_file()) filenames.push_back(entry.path().string());
+            }
+        }
+        else
+        {
+            filenames.push_back(arguments[i]);
+        }
+    }
+
+    std::map<vsg::Path, Totals> totals;
+    size_t numLeftToSTB = 0;
+
+    for (auto& filename : filenames)
+    {
+        std::ifstream fin(filename, std::ios::in | std::ios::binary);
+        std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+        auto start = clock::now();
+        vsg::ref_ptr<vsg::Data> data;
+        for (uint32_t i = 0; i < iterations; ++i) data = readBackend(buffer, mapRGBtoRGBAHint);
+        double backendTime = std::chrono::duration<double>(clock::now() - start).count();
+
+        // only compare the images one of the backends decodes, the rest are decoded by stb_image either way.
+        if (!data)
+        {
+            ++numLeftToSTB;
+            continue;
+        }
+
+        int width = 0, height = 0, components = 0;
+        stbi_uc* pixels = nullptr;
+        start = clock::now();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            stbi_image_free(pixels);
+            pixels = readSTB(buffer, mapRGBtoRGBAHint, width, height, components);
+        }
+        double stbTime = std::chrono::duration<double>(clock::now() - start).count();
+
+        auto& total = totals[vsg::lowerCaseFileExtension(filename)];
+        ++total.numImages;
+        total.megaPixels += double(width) * double(height) * double(iterations) / 1.0e6;
+        total.backendTime += backendTime;
+        total.stbTime += stbTime;
+
+        size_t size = size_t(width) * size_t(height) * size_t(components);
+        if (!pixels || data->dataSize() != size)
+        {
+            std::cerr << "Error: " << filename << " decoded to " << data->dataSize() << " bytes by the backend and " << size << " bytes by stb_image." << std::endl;
+            ++total.numDiffering;
+        }
+        else
+        {
+            auto backendPixels = static_cast<const uint8_t*>(data->dataPointer());
+            int maxDifference = 0;
+            for (size_t b = 0; b < size; ++b) maxDifference = std::max(maxDifference, std::abs(int(backendPixels[b]) - int(pixels[b])));
+            total.maxDifference = std::max(total.maxDifference, maxDifference);
+            if (maxDifference > 0) ++total.numDiffering;
+        }
+
+        stbi_image_free(pixels);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << filenames.size() << " files, " << numLeftToSTB << " left to stb_image by the backends in this build" << std::endl;
+
+    int result = 0;
+    for (auto& [ext, total] : totals)
+    {
+        std::cout << ext << " : " << total.numImages << " images" << std::endl;
+        std::cout << "    backend   : " << total.megaPixels / total.backendTime << " megapixels/s" << std::endl;
+        std::cout << "    stb_image : " << total.megaPixels / total.stbTime << " megapixels/s" << std::endl;
+        std::cout << "    speedup " << total.stbTime / total.backendTime << ", " << total.numDiffering << " images differ, max difference " << total.maxDifference << std::endl;
+
+        // lossless PNG decoding must match stb_image exactly, JPEG decoders are allowed to round the inverse DCT differently.
+        if (ext == ".png" && total.numDiffering > 0) result = 1;
+    }
+
+    return result;
+}
@@ -0,0 +1,192 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+#include <vsgXchange/images.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/resource.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace image_read
+{
+    struct File
+    {
+        vsg::Path filename;
+        size_t size = 0;
+    };
+
+    struct PageFaults
+    {
+        long major = 0;
+        long minor = 0;
+    };
+
+    PageFaults pageFaults()
+    {
+        PageFaults faults;
+#if !defined(_WIN32)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            faults.major = usage.ru_majflt;
+            faults.minor = usage.ru_minflt;
+        }
+#endif
+        return faults;
+    }
+
+    /// ask the kernel to drop the files from the page cache so the next read has to go to disk, returns false if not supported.
+    bool evict(const std::vector<File>& files)
+    {
+#if !defined(_WIN32)
+        for (auto& file : files)
+        {
+            int fd = open(file.filename.c_str(), O_RDONLY);
+            if (fd < 0) continue;
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// fraction of the files' pages that are in the page cache, or -1 if not supported.
+    double residency(const std::vector<File>& files)
+    {
+#if !defined(_WIN32)
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t numPages = 0;
+        size_t numResident = 0;
+        std::vector<unsigned char> pages;
+        for (auto& file : files)
+        {
+            int fd = open(file.filename.c_str(), O_RDONLY);
+            if (fd < 0) continue;
+
+            void* ptr = mmap(nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (ptr == MAP_FAILED) continue;
+
+            pages.resize((file.size + pageSize - 1) / pageSize);
+            if (mincore(ptr, file.size, pages.data()) == 0)
+            {
+                numPages += pages.size();
+                for (auto page : pages) numResident += (page & 1);
+            }
+            munmap(ptr, file.size);
+        }
+        return numPages > 0 ? double(numResident) / double(numPages) : 0.0;
+#else
+        return -1.0;
+#endif
+    }
+
+    /// read a file into a buffer and decode it from memory, as the readers did before reading from a memory mapping.
+    vsg::ref_ptr<vsg::Object> readBuffered(const vsg::ReaderWriter& reader, const File& file, vsg::ref_ptr<vsg::Options> options)
+    {
+        std::ifstream fin(file.filename, std::ios::in | std::ios::binary);
+        std::vector<uint8_t> buffer(file.size);
+        if (!fin.read(reinterpret_cast<char*>(buffer.data()), buffer.size())) return {};
+
+        options->extensionHint = vsg::lowerCaseFileExtension(file.filename);
+        return reader.read(buffer.data(), buffer.size(), options);
+    }
+
+} // namespace image_read
+
+int main(int argc, char** argv)
+{
+    using namespace image_read;
+    using clock = std::chrono::steady_clock;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (argc <= 1 || arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    image_read [--warm] directory [directory ...]" << std::endl;
+        std::cout << "Reads all the images in the directories through the path read, which decodes from a MappedFile," << std::endl;
+        std::cout << "and through the memory read of a buffer the whole file has been read into, reporting MB/s and page cache behaviour for both." << std::endl;
+        std::cout << "The files are dropped from the page cache before each cold pass, --warm skips the cold passes." << std::endl;
+        return 1;
+    }
+
+    bool warmOnly = arguments.read("--warm");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<File> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        for (auto& entry : std::filesystem::recursive_directory_iterator(arguments[i]))
+        {
+            if (entry.is_regular_file()) files.push_back(File{entry.path().string(), static_cast<size_t>(entry.file_size())});
+        }
+    }
+
+    double totalMB = 0.0;
+    for (auto& file : files) totalMB += double(file.size) / (1024.0 * 1024.0);
+
+    std::cout << files.size() << " files, " << totalMB << "MB" << std::endl;
+
+    vsg::ref_ptr<vsg::ReaderWriter> reader = vsgXchange::images::create();
+    auto options = vsg::Options::create();
+
+    bool canEvict = !warmOnly && evict(files);
+    if (!warmOnly && !canEvict) std::cout << "Page cache eviction not supported, only warm passes are run." << std::endl;
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (bool mapped : {true, false})
+    {
+        for (bool cold : {true, false})
+        {
+            if (cold && !canEvict) continue;
+            if (cold) evict(files);
+
+            double residencyBefore = residency(files);
+            auto faultsBefore = pageFaults();
+
+            auto bufferedOptions = vsg::Options::create();
+            size_t numRead = 0;
+            auto start = clock::now();
+            for (auto& file : files)
+            {
+                auto object = mapped ? reader->read(file.filename, options) : readBuffered(*reader, file, bufferedOptions);
+                if (object) ++numRead;
+            }
+            double time = std::chrono::duration<double>(clock::now() - start).count();
+
+            auto faultsAfter = pageFaults();
+            double residencyAfter = residency(files);
+
+            std::cout << (mapped ? "path    " : "buffered") << (cold ? " cold : " : " warm : ") << numRead << " images in " << time << "s, "
+                      << totalMB / time << "MB/s, " << double(numRead) / time << " images/s, page faults " << (faultsAfter.major - faultsBefore.major) << " major "
+                      << (faultsAfter.minor - faultsBefore.minor) << " minor, page cache residency " << residencyBefore * 100.0 << "% -> " << residencyAfter * 100.0 << "%" << std::endl;
+        }
+    }
+
+    return 0;
+}
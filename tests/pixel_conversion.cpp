@@ -0,0 +1,135 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2021 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include <vsg/all.h>
+
+// compiled together with the pixel conversion source so that the scalar implementations can be called directly.
+#include "PixelConversion.cpp"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace pixel_conversion
+{
+    struct Conversion
+    {
+        std::string name;
+        uint32_t srcComponents;
+        uint32_t dstComponents;
+        std::function<void(const uint8_t*, uint8_t*, size_t)> scalar;
+        std::function<void(const uint8_t*, uint8_t*, size_t)> dispatched;
+    };
+
+    /// time iterations of the conversion of numPixels, returning the best time of a single iteration so that the other processes running don't skew the result.
+    double time(const std::function<void(const uint8_t*, uint8_t*, size_t)>& convert, const std::vector<uint8_t>& src, std::vector<uint8_t>& dst, size_t numPixels, uint32_t iterations)
+    {
+        using clock = std::chrono::steady_clock;
+
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            auto start = clock::now();
+            convert(src.data(), dst.data(), numPixels);
+            best = std::min(best, std::chrono::duration<double>(clock::now() - start).count());
+        }
+        return best;
+    }
+
+    const char* simdName()
+    {
+#if defined(PIXEL_CONVERSION_SSSE3)
+        return useSSSE3() ? "SSSE3" : "scalar, SSSE3 not supported by this CPU";
+#elif defined(PIXEL_CONVERSION_NEON)
+        return "NEON";
+#else
+        return "scalar, no SIMD implementation for this architecture";
+#endif
+    }
+
+} // namespace pixel_conversion
+
+int main(int argc, char** argv)
+{
+    using namespace pixel_conversion;
+
+    vsg::CommandLine arguments(&argc, argv);
+
+    if (arguments.read({"-h", "--help"}))
+    {
+        std::cout << "Usage:\n    pixel_conversion [--pixels 4194304] [--iterations 20]" << std::endl;
+        std::cout << "Times convertRGBtoRGBA and swapRedBlue with the scalar implementations and with the SIMD implementations selected at runtime," << std::endl;
+        std::cout << "checking the two produce identical results across a range of image sizes that exercise the scalar tail of the SIMD loops." << std::endl;
+        return 1;
+    }
+
+    auto numPixels = arguments.value(size_t(4096 * 1024), "--pixels");
+    auto iterations = arguments.value(20u, "--iterations");
+
+    if (arguments.errors()) return arguments.writeErrorMessages(std::cerr);
+
+    std::vector<Conversion> conversions{
+        {"convertRGBtoRGBA", 3, 4,
+         [](const uint8_t* src, uint8_t* dst, size_t n) { convertRGBtoRGBA_scalar(src, dst, n, false); },
+         [](const uint8_t* src, uint8_t* dst, size_t n) { vsgXchange::convertRGBtoRGBA(src, dst, n, false); }},
+        {"convertRGBtoRGBA swap", 3, 4,
+         [](const uint8_t* src, uint8_t* dst, size_t n) { convertRGBtoRGBA_scalar(src, dst, n, true); },
+         [](const uint8_t* src, uint8_t* dst, size_t n) { vsgXchange::convertRGBtoRGBA(src, dst, n, true); }},
+        {"swapRedBlue RGB", 3, 3,
+         [](const uint8_t* src, uint8_t* dst, size_t n) { swapRedBlue_scalar(src, dst, n, 3); },
+         [](const uint8_t* src, uint8_t* dst, size_t n) { vsgXchange::swapRedBlue(src, dst, n, 3); }},
+        {"swapRedBlue RGBA", 4, 4,
+         [](const uint8_t* src, uint8_t* dst, size_t n) { swapRedBlue_scalar(src, dst, n, 4); },
+         [](const uint8_t* src, uint8_t* dst, size_t n) { vsgXchange::swapRedBlue(src, dst, n, 4); }}};
+
+    std::vector<uint8_t> src(numPixels * 4);
+    std::mt19937 random(1);
+    for (auto& value : src) value = static_cast<uint8_t>(random());
+
+    std::vector<uint8_t> scalarResult(numPixels * 4);
+    std::vector<uint8_t> dispatchedResult(numPixels * 4);
+
+    std::cout << "SIMD implementation : " << simdName() << std::endl;
+    std::cout << numPixels << " pixels, best of " << iterations << " iterations" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+
+    int result = 0;
+    for (auto& conversion : conversions)
+    {
+        // odd sizes leave pixels over for the scalar tail of the SIMD loops.
+        size_t numMismatched = 0;
+        for (size_t n : {size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), size_t(31), size_t(1021), numPixels})
+        {
+            n = std::min(n, numPixels);
+            std::fill(scalarResult.begin(), scalarResult.end(), uint8_t(0));
+            std::fill(dispatchedResult.begin(), dispatchedResult.end(), uint8_t(0));
+            conversion.scalar(src.data(), scalarResult.data(), n);
+            conversion.dispatched(src.data(), dispatchedResult.data(), n);
+            if (std::memcmp(scalarResult.data(), dispatchedResult.data(), scalarResult.size()) != 0) ++numMismatched;
+        }
+
+        double scalarTime = time(conversion.scalar, src, scalarResult, numPixels, iterations);
+        double dispatchedTime = time(conversion.dispatched, src, dispatchedResult, numPixels, iterations);
+
+        double bytes = double(numPixels) * double(conversion.srcComponents + conversion.dstComponents);
+        std::cout << std::setw(22) << conversion.name << " : scalar " << bytes / scalarTime / (1024.0 * 1024.0) << "MB/s, SIMD " << bytes / dispatchedTime / (1024.0 * 1024.0)
+                  << "MB/s, speedup " << scalarTime / dispatchedTime << (numMismatched > 0 ? ", results differ" : "") << std::endl;
+
+        if (numMismatched > 0) result = 1;
+    }
+
+    return result;
+}